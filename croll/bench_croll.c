@@ -0,0 +1,249 @@
+// bench_croll.c
+// build: cc -O2 -pthread croll/bench_croll.c -o bench_croll
+#define CROLL_STRIP_PREFIX
+#define CROLL_IMPLEMENTATION
+#include "croll.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH(name) do { \
+    printf("[BENCH] %s\n", #name); \
+    name(); \
+} while(0)
+
+double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// MPMC queue throughput
+
+#define MPMC_BENCH_ITEMS (1 << 21)
+
+typedef struct {
+    croll_MpmcQueue *q;
+    size_t count;
+    croll_u64 sum;
+} mpmc_bench_arg;
+
+void *mpmc_bench_producer(void *p) {
+    mpmc_bench_arg *arg = p;
+    for (croll_u64 i = 0; i < arg->count; i++)
+        croll_mpmcPush(arg->q, &i);
+    return NULL;
+}
+
+void *mpmc_bench_consumer(void *p) {
+    mpmc_bench_arg *arg = p;
+    croll_u64 value;
+    for (size_t i = 0; i < arg->count; i++) {
+        croll_mpmcPop(arg->q, &value);
+        arg->sum += value;
+    }
+    return NULL;
+}
+
+void bench_mpmc() {
+    int configs[][2] = {{1, 1}, {1, 4}, {4, 1}, {2, 2}, {4, 4}, {8, 8}};
+
+    for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+        int producers = configs[c][0], consumers = configs[c][1];
+        croll_MpmcQueue *q = croll_mpmcNew(1024, sizeof(croll_u64));
+
+        pthread_t threads[16];
+        mpmc_bench_arg args[16];
+        double start = now_seconds();
+        for (int i = 0; i < producers; i++) {
+            args[i] = (mpmc_bench_arg){q, MPMC_BENCH_ITEMS / producers, 0};
+            pthread_create(&threads[i], NULL, mpmc_bench_producer, &args[i]);
+        }
+        for (int i = producers; i < producers + consumers; i++) {
+            args[i] = (mpmc_bench_arg){q, MPMC_BENCH_ITEMS / consumers, 0};
+            pthread_create(&threads[i], NULL, mpmc_bench_consumer, &args[i]);
+        }
+        for (int i = 0; i < producers + consumers; i++)
+            pthread_join(threads[i], NULL);
+        double elapsed = now_seconds() - start;
+
+        printf("   %d producers / %d consumers: %7.2f Mops/s\n", producers, consumers, MPMC_BENCH_ITEMS / elapsed / 1e6);
+        croll_mpmcDestroy(q);
+    }
+}
+
+// heap: binary vs 4-ary vs 8-ary
+
+#define HEAP_BENCH_OPS 10000000
+
+void bench_heap() {
+    size_t arities[] = {2, 4, 8};
+
+    for (size_t a = 0; a < sizeof(arities) / sizeof(arities[0]); a++) {
+        croll_Heap heap = {.arity = arities[a]};
+        croll_u64 seed = 88172645463325252ull, checksum = 0;
+
+        double start = now_seconds();
+        // half pushes of random keys, then pop everything back out
+        for (size_t i = 0; i < HEAP_BENCH_OPS / 2; i++) {
+            seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+            croll_heapPush(&heap, seed, i);
+        }
+        while (heap.nodes.len > 0)
+            checksum += croll_heapPop(&heap).value;
+        double elapsed = now_seconds() - start;
+
+        printf("   %zu-ary: %6.3f s for %d ops (%.1f ns/op, checksum %llu)\n", arities[a], elapsed, HEAP_BENCH_OPS,
+               elapsed * 1e9 / HEAP_BENCH_OPS, (unsigned long long)checksum);
+        croll_heapFree(&heap);
+    }
+}
+
+// search array: binary search vs Eytzinger vs batched Eytzinger
+
+#define SEARCH_BENCH_KEYS (1 << 24)
+#define SEARCH_BENCH_QUERIES (1 << 22)
+
+size_t bench_binary_lower_bound(const croll_u64 *a, size_t n, croll_u64 key) {
+    size_t lo = 0;
+    while (n > 1) {
+        size_t half = n / 2;
+        lo = a[lo + half - 1] < key ? lo + half : lo;
+        n -= half;
+    }
+    return lo + (n == 1 && a[lo] < key);
+}
+
+void bench_search() {
+    croll_daDecl(croll_u64, ) sorted = {0};
+    croll_daReserve(&sorted, SEARCH_BENCH_KEYS);
+    for (croll_u64 i = 0; i < SEARCH_BENCH_KEYS; i++)
+        croll_daAppend(&sorted, i * 2);
+    croll_SearchArray sa = croll_searchFromDa(&sorted);
+
+    croll_u64 *queries = malloc(SEARCH_BENCH_QUERIES * sizeof(croll_u64));
+    size_t *out = malloc(SEARCH_BENCH_QUERIES * sizeof(size_t));
+    croll_u64 seed = 88172645463325252ull;
+    for (size_t i = 0; i < SEARCH_BENCH_QUERIES; i++) {
+        seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+        queries[i] = seed % (2 * SEARCH_BENCH_KEYS);
+    }
+
+    size_t checksum = 0;
+    double start = now_seconds();
+    for (size_t i = 0; i < SEARCH_BENCH_QUERIES; i++)
+        checksum += bench_binary_lower_bound(sorted.data, sorted.len, queries[i]);
+    double elapsed = now_seconds() - start;
+    printf("   binary search: %6.1f ns/lookup (checksum %zu)\n", elapsed * 1e9 / SEARCH_BENCH_QUERIES, checksum);
+
+    checksum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < SEARCH_BENCH_QUERIES; i++)
+        checksum += croll_searchLowerBound(&sa, queries[i]);
+    elapsed = now_seconds() - start;
+    printf("   eytzinger:     %6.1f ns/lookup (checksum %zu)\n", elapsed * 1e9 / SEARCH_BENCH_QUERIES, checksum);
+
+    checksum = 0;
+    start = now_seconds();
+    croll_searchLowerBoundBatch(&sa, queries, SEARCH_BENCH_QUERIES, out);
+    for (size_t i = 0; i < SEARCH_BENCH_QUERIES; i++)
+        checksum += out[i];
+    elapsed = now_seconds() - start;
+    printf("   batched:       %6.1f ns/lookup (checksum %zu)\n", elapsed * 1e9 / SEARCH_BENCH_QUERIES, checksum);
+
+    free(queries);
+    free(out);
+    croll_searchFree(&sa);
+    croll_daFree(&sorted);
+}
+
+// B+tree vs sorted array + binary search, mixed inserts and lookups
+
+#define BTREE_BENCH_OPS 400000
+
+void bench_btree() {
+    croll_u64 seed = 88172645463325252ull;
+    size_t found = 0;
+
+    croll_daDecl(croll_u64, ) sorted = {0};
+    double start = now_seconds();
+    for (size_t i = 0; i < BTREE_BENCH_OPS; i++) {
+        seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+        croll_u64 key = seed % (BTREE_BENCH_OPS * 4);
+        size_t pos = bench_binary_lower_bound(sorted.data, sorted.len, key);
+        if (i % 2 == 0) {
+            if (pos < sorted.len && sorted.data[pos] == key) continue;
+            croll_daAppend(&sorted, 0);
+            memmove(sorted.data + pos + 1, sorted.data + pos, (sorted.len - pos - 1) * sizeof(croll_u64));
+            sorted.data[pos] = key;
+        } else {
+            found += pos < sorted.len && sorted.data[pos] == key;
+        }
+    }
+    double elapsed = now_seconds() - start;
+    printf("   sorted array: %6.1f ns/op (%zu keys, %zu hits)\n", elapsed * 1e9 / BTREE_BENCH_OPS, sorted.len, found);
+    croll_daFree(&sorted);
+
+    seed = 88172645463325252ull;
+    found = 0;
+    croll_BTree *tree = croll_btreeNew();
+    start = now_seconds();
+    for (size_t i = 0; i < BTREE_BENCH_OPS; i++) {
+        seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+        croll_u64 key = seed % (BTREE_BENCH_OPS * 4);
+        if (i % 2 == 0) croll_btreeSet(tree, key, (void *)1);
+        else found += croll_btreeGet(tree, key) != NULL;
+    }
+    elapsed = now_seconds() - start;
+    printf("   b+tree:       %6.1f ns/op (%zu keys, %zu hits)\n", elapsed * 1e9 / BTREE_BENCH_OPS, tree->len, found);
+    croll_btreeDestroy(tree);
+}
+
+// pool allocator vs malloc: fill, free every other chunk, refill
+
+#define POOL_BENCH_CHUNKS (1 << 20)
+
+void bench_pool() {
+    void **ptrs = malloc(POOL_BENCH_CHUNKS * sizeof(void *));
+
+    double start = now_seconds();
+    for (size_t i = 0; i < POOL_BENCH_CHUNKS; i++)
+        ptrs[i] = malloc(32);
+    for (size_t i = 0; i < POOL_BENCH_CHUNKS; i += 2)
+        free(ptrs[i]);
+    for (size_t i = 0; i < POOL_BENCH_CHUNKS; i += 2)
+        ptrs[i] = malloc(32);
+    double elapsed = now_seconds() - start;
+    for (size_t i = 0; i < POOL_BENCH_CHUNKS; i++)
+        free(ptrs[i]);
+    printf("   malloc: %6.1f ns/op\n", elapsed * 1e9 / (POOL_BENCH_CHUNKS * 2));
+
+    // a small first block, so most chunks come from grown blocks
+    croll_PoolAlloc *pool = croll_poolNew(1024, 32);
+    start = now_seconds();
+    for (size_t i = 0; i < POOL_BENCH_CHUNKS; i++)
+        ptrs[i] = croll_poolAlloc(pool);
+    for (size_t i = 0; i < POOL_BENCH_CHUNKS; i += 2)
+        croll_poolFree(pool, ptrs[i]);
+    for (size_t i = 0; i < POOL_BENCH_CHUNKS; i += 2)
+        ptrs[i] = croll_poolAlloc(pool);
+    elapsed = now_seconds() - start;
+    printf("   pool:   %6.1f ns/op\n", elapsed * 1e9 / (POOL_BENCH_CHUNKS * 2));
+    croll_poolDestroy(pool);
+
+    free(ptrs);
+}
+
+int main(void) {
+    croll_init();
+    logInfo("Running benchmarks...\n");
+
+    BENCH(bench_mpmc);
+    BENCH(bench_heap);
+    BENCH(bench_search);
+    BENCH(bench_btree);
+    BENCH(bench_pool);
+
+    return 0;
+}
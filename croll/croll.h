@@ -41,7 +41,9 @@
     Implementation macros:
         CROLL_IMPLEMENTATION, CROLL_HASHTABLE_IMPLEMENTATION
     Helper macros:
-        CROLL_STRIP_PREFIX, CROLL_STATIC_FUNC, CROLL_MAX_TEXTFMT_BUFFERS, CROLL_TEXTFMT_BUFFER_SIZE
+        CROLL_STRIP_PREFIX, CROLL_STATIC_FUNC, CROLL_MAX_TEXTFMT_BUFFERS, CROLL_TEXTFMT_BUFFER_SIZE,
+        CROLL_NO_SIMD, CROLL_SEG_BASE_SHIFT, CROLL_SLOTMAP_HANDLE32, CROLL_BUMP_MAX_BLOCK_SIZE,
+        CROLL_VARENA_COMMIT_SIZE, CROLL_SCRATCH_SIZE, CROLL_BUMP_STATS, CROLL_POOL_VALIDATE
 
 
 
@@ -52,12 +54,29 @@
 
 #include <assert.h>
 #include <stdarg.h>
+#ifndef __cplusplus
+#include <stdatomic.h>
+#endif
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
 
+// virtual memory arena (reserve/commit), needs the mmap extensions (anonymous maps, madvise).
+// glibc hides them under a strict -std=c11 / -std=c99, define _DEFAULT_SOURCE (or _GNU_SOURCE)
+// before any include to keep croll_VArena there.
+#if defined(__APPLE__) || (defined(__unix__) && (!defined(__STRICT_ANSI__) || defined(_DEFAULT_SOURCE) || \
+                                                 defined(_GNU_SOURCE) || defined(_BSD_SOURCE)))
+#define CROLL_HAS_VARENA 1
+#endif
+
+// SIMD kernels are compiled per target and picked at runtime, so no -m flags are needed
+#if !defined(CROLL_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CROLL__X86_SIMD 1
+#include <immintrin.h>
+#endif
+
 //======================================================================
 // CRoll specific parts
 //======================================================================
@@ -96,6 +115,13 @@ static FILE *croll_STDOUT;
 
 #define croll_ALLOC_ALIGN(size) (((size) + 7) & ~7)
 
+#define CROLL_CACHE_LINE 64
+
+// Largest block a growing bump arena chains (bigger requests get a side block their size)
+#ifndef CROLL_BUMP_MAX_BLOCK_SIZE
+    #define CROLL_BUMP_MAX_BLOCK_SIZE ((size_t)64 * 1024 * 1024)
+#endif
+
 
 // dynamic array macros
 
@@ -108,7 +134,19 @@ static FILE *croll_STDOUT;
 #define croll_daDeclEnd() }
 #define croll_daDecl(type, name) croll_daDeclStart(type, name) croll_daDeclEnd()
 
-#define croll_daFree(da) do {free((da)->data); (da)->data = NULL; (da)->len = 0; (da)->cap = 0;} while(0)
+// Same as croll_daDecl but the first N elements live inside the struct,
+// the array only allocates once it grows past N. It must be initialized with
+// croll_daInlineInit (or croll_daInlineReset) and must not be copied or moved while inline.
+// Example use:
+// croll_daDeclInline(int, , 8) arr = croll_daInlineInit(arr);
+// croll_daAppend(&arr, 1); // no allocation
+#define croll_daDeclInline(type, name, N) struct name { type *data; size_t len, cap; type _inline[N]; }
+#define croll_daInlineInit(da) { .data = (da)._inline, .len = 0, .cap = sizeof((da)._inline) / sizeof((da)._inline[0]) }
+#define croll_daInlineReset(da) do {(da)->data = (da)->_inline; (da)->len = 0; (da)->cap = sizeof((da)->_inline) / sizeof((da)->_inline[0]);} while(0)
+// true while the elements are stored inside the struct itself (a heap buffer can never be there)
+#define croll__daIsInline(da) ((uintptr_t)(da)->data >= (uintptr_t)(da) && (uintptr_t)(da)->data < (uintptr_t)((da) + 1))
+
+#define croll_daFree(da) do {if (!croll__daIsInline(da)) free((da)->data); (da)->data = NULL; (da)->len = 0; (da)->cap = 0;} while(0)
 
 #define croll_daInitCap 64
 #define croll_daReserve(da, expect)                                                                   \
@@ -118,8 +156,15 @@ static FILE *croll_STDOUT;
                 (da)->cap = croll_daInitCap;                                                          \
             while ((da)->cap < (expect))                                                              \
                 (da)->cap *= 2;                                                                       \
-            (da)->data = realloc((da)->data, (da)->cap * sizeof(*(da)->data));    \
-            croll_ASSERT((da)->data != NULL, "Failed to reallocate data array at file: "__FILE__);    \
+            if (croll__daIsInline(da)) {                                                              \
+                void *croll__spill = malloc((da)->cap * sizeof(*(da)->data));                         \
+                croll_ASSERT(croll__spill != NULL, "Failed to allocate data array at file: "__FILE__); \
+                memcpy(croll__spill, (da)->data, (da)->len * sizeof(*(da)->data));                    \
+                (da)->data = croll__spill;                                                            \
+            } else {                                                                                  \
+                (da)->data = realloc((da)->data, (da)->cap * sizeof(*(da)->data));                    \
+                croll_ASSERT((da)->data != NULL, "Failed to reallocate data array at file: "__FILE__); \
+            }                                                                                         \
         }                                                                                             \
     } while(0)
 
@@ -141,6 +186,175 @@ static FILE *croll_STDOUT;
 #define croll_daForEach(type, it, da) for(type *it = (da)->data; it < (da)->data + (da)->len; it++)
 #define croll_daForEach_index(it, da) ((it) - (da)->data)
 
+// Reductions over arrays of croll_i32, croll_u32, croll_i64, croll_u64, croll_f32 or croll_f64.
+// Min, Max and ArgMax assert that the array isn't empty.
+// Example use:
+// croll_daDecl(int,) arr = {0};
+// ...
+// int max = croll_daMax(&arr);
+#define croll__daReduceSelect(da, op) _Generic(*(da)->data, \
+        croll_i32: croll_da##op##I32,                       \
+        croll_u32: croll_da##op##U32,                       \
+        croll_i64: croll_da##op##I64,                       \
+        croll_u64: croll_da##op##U64,                       \
+        croll_f32: croll_da##op##F32,                       \
+        croll_f64: croll_da##op##F64)
+#define croll_daMin(da) croll__daReduceSelect(da, Min)((da)->data, (da)->len)
+#define croll_daMax(da) croll__daReduceSelect(da, Max)((da)->data, (da)->len)
+#define croll_daSum(da) croll__daReduceSelect(da, Sum)((da)->data, (da)->len)
+#define croll_daArgMax(da) croll__daReduceSelect(da, ArgMax)((da)->data, (da)->len)
+#define croll_daCount(da, value) croll__daReduceSelect(da, Count)((da)->data, (da)->len, (value))
+
+// struct-of-arrays macros
+
+// Declares `name` holding one array per field (all sharing a single len/cap) and `struct name##Row`
+// holding one value of every field, the field list is an X-macro of (type, field) pairs.
+// Scans that only need a couple of fields then only load those columns.
+// Example use:
+// #define PARTICLE_FIELDS(X) X(float, x) X(float, y) X(int, id)
+// croll_soaDecl(Particles, PARTICLE_FIELDS);
+// Particles ps = {0};
+// croll_soaAppend(Particles, &ps, .x = 1.0f, .y = 2.0f, .id = 7);
+// for(size_t i = 0; i < ps.len; i++) sum += ps.x[i];
+// croll_soaFree(Particles, &ps);
+#define CROLL__SOA_COLUMN(type, field) type *field;
+#define CROLL__SOA_FIELD(type, field) type field;
+#define CROLL__SOA_GROW(type, field)                                                          \
+    soa->field = realloc(soa->field, cap * sizeof(type));                                     \
+    croll_ASSERT(soa->field != NULL, "Failed to reallocate column at file: "__FILE__);
+#define CROLL__SOA_STORE(type, field) soa->field[soa->len] = row.field;
+#define CROLL__SOA_LOAD(type, field) row.field = soa->field[i];
+#define CROLL__SOA_FREE(type, field) free(soa->field); soa->field = NULL;
+
+#define croll_soaDecl(name, fields)                                                           \
+    struct name { fields(CROLL__SOA_COLUMN) size_t len, cap; };                               \
+    struct name##Row { fields(CROLL__SOA_FIELD) };                                            \
+    static inline void croll__soaReserve_##name(struct name *soa, size_t expect) {           \
+        if (expect <= soa->cap) return;                                                       \
+        size_t cap = soa->cap ? soa->cap : croll_daInitCap;                                   \
+        while (cap < expect) cap *= 2;                                                        \
+        fields(CROLL__SOA_GROW)                                                               \
+        soa->cap = cap;                                                                       \
+    }                                                                                         \
+    static inline void croll__soaAppend_##name(struct name *soa, struct name##Row row) {     \
+        croll__soaReserve_##name(soa, soa->len + 1);                                          \
+        fields(CROLL__SOA_STORE)                                                              \
+        soa->len++;                                                                           \
+    }                                                                                         \
+    static inline struct name##Row croll__soaGet_##name(const struct name *soa, size_t i) {  \
+        croll_ASSERT(i < soa->len, "Row index out of range at file: "__FILE__);              \
+        struct name##Row row;                                                                 \
+        fields(CROLL__SOA_LOAD)                                                               \
+        return row;                                                                           \
+    }                                                                                         \
+    static inline void croll__soaFree_##name(struct name *soa) {                             \
+        fields(CROLL__SOA_FREE)                                                               \
+        soa->len = 0;                                                                         \
+        soa->cap = 0;                                                                         \
+    }                                                                                         \
+    typedef struct name name
+
+#define croll_soaReserve(name, soa, expect) croll__soaReserve_##name((soa), (expect))
+#define croll_soaAppend(name, soa, ...) croll__soaAppend_##name((soa), (struct name##Row){__VA_ARGS__})
+#define croll_soaGet(name, soa, i) croll__soaGet_##name((soa), (i))
+#define croll_soaFree(name, soa) croll__soaFree_##name(soa)
+
+// 2D grid macros
+
+// A rows x cols grid in one contiguous allocation, either row-major or tiled
+// (square tiles of 2^tile_shift elements per side, each tile stored contiguously).
+// Rows and columns are padded to whole tiles, `stride` is the padded column count.
+// Example use:
+// croll_gridDecl(char, ) grid = {0};
+// croll_gridInit(&grid, rows, cols);
+// croll_gridAt(&grid, r, c) = '1';
+// croll_gridForEachInRow(char, it, &grid, r) putchar(*it);
+// croll_gridFree(&grid);
+#define croll_gridDecl(type, name) struct name { type *data; size_t rows, cols, stride; size_t tile_shift; }
+
+#define croll_gridInitTiled(g, nrows, ncols, tshift)                                              \
+    do {                                                                                          \
+        size_t croll__tile = (size_t)1 << (tshift);                                               \
+        (g)->rows = (nrows);                                                                      \
+        (g)->cols = (ncols);                                                                      \
+        (g)->tile_shift = (tshift);                                                               \
+        (g)->stride = ((ncols) + croll__tile - 1) & ~(croll__tile - 1);                           \
+        size_t croll__cells = (((nrows) + croll__tile - 1) & ~(croll__tile - 1)) * (g)->stride;  \
+        (g)->data = calloc(croll__cells > 0 ? croll__cells : 1, sizeof(*(g)->data));             \
+        croll_ASSERT((g)->data != NULL, "Failed to allocate grid at file: "__FILE__);             \
+    } while(0)
+#define croll_gridInit(g, nrows, ncols) croll_gridInitTiled(g, nrows, ncols, 0)
+
+#define croll_gridFree(g) do {free((g)->data); (g)->data = NULL; (g)->rows = 0; (g)->cols = 0; (g)->stride = 0;} while(0)
+
+#define croll_gridAt(g, r, c) ((g)->data[croll__gridIndex((r), (c), (g)->stride, (g)->tile_shift)])
+
+// Row and column iteration, stride-1 along rows (row-major grids only)
+#define croll_gridRow(g, r) ((g)->data + (r) * (g)->stride)
+#define croll_gridForEachInRow(type, it, g, r)                                                    \
+    for(type *it = (croll_ASSERT((g)->tile_shift == 0, "Grid is not row-major at file: "__FILE__), croll_gridRow(g, r)); \
+        it < croll_gridRow(g, r) + (g)->cols; it++)
+#define croll_gridForEachInCol(type, it, g, c)                                                    \
+    for(type *it = (croll_ASSERT((g)->tile_shift == 0, "Grid is not row-major at file: "__FILE__), (g)->data + (c)); \
+        it < (g)->data + (g)->rows * (g)->stride; it += (g)->stride)
+
+// dst must be a row-major src->cols x src->rows grid of the same element type
+#define croll_gridTranspose(dst, src)                                                             \
+    do {                                                                                          \
+        croll_ASSERT((dst)->rows == (src)->cols && (dst)->cols == (src)->rows, "Grid sizes don't match at file: "__FILE__); \
+        croll_ASSERT((dst)->tile_shift == 0 && (src)->tile_shift == 0, "Grid is not row-major at file: "__FILE__); \
+        croll_ASSERT(sizeof(*(dst)->data) == sizeof(*(src)->data), "Grid types don't match at file: "__FILE__); \
+        croll__gridTranspose((dst)->data, (src)->data, (src)->rows, (src)->cols,                  \
+                             (src)->stride, (dst)->stride, sizeof(*(src)->data));                 \
+    } while(0)
+
+// segmented array macros
+
+// A growable array made of power-of-two segments that are never moved,
+// so pointers to its elements stay valid while it grows and appending never copies.
+// Segment k holds croll_segBaseCap << k elements.
+// Example use:
+// croll_segDecl(int, ) arr = {0};
+// croll_segAppend(&arr, 42);
+// int *first = &croll_segAt(&arr, 0); // still valid after further appends
+#ifndef CROLL_SEG_BASE_SHIFT
+#define CROLL_SEG_BASE_SHIFT 6
+#endif
+#define croll_segBaseCap ((size_t)1 << CROLL_SEG_BASE_SHIFT)
+#define CROLL__SEG_MAX (sizeof(size_t) * 8 - CROLL_SEG_BASE_SHIFT)
+#define croll_segDecl(type, name) struct name { type *segs[CROLL__SEG_MAX]; size_t len, cap; }
+
+#define croll_segAt(sa, i) ((sa)->segs[croll__segIndex(i)][croll__segOffset(i)])
+
+#define croll_segReserve(sa, expect)                                                                 \
+    do {                                                                                             \
+        while ((sa)->cap < (expect)) {                                                               \
+            size_t croll__seg = croll__segIndex((sa)->cap);                                          \
+            (sa)->segs[croll__seg] = malloc(croll__segCap(croll__seg) * sizeof(*(sa)->segs[0]));     \
+            croll_ASSERT((sa)->segs[croll__seg] != NULL, "Failed to allocate segment at file: "__FILE__); \
+            (sa)->cap += croll__segCap(croll__seg);                                                  \
+        }                                                                                            \
+    } while(0)
+
+#define croll_segAppend(sa, value)               \
+    do {                                         \
+        croll_segReserve((sa), (sa)->len+1);     \
+        croll_segAt((sa), (sa)->len) = (value);  \
+        (sa)->len++;                             \
+    } while(0)
+
+#define croll_segLast(sa) croll_segAt((sa), (croll_ASSERT((sa)->len > 0, "Segmented array is empty at file: "__FILE__), (sa)->len-1))
+
+#define croll_segFree(sa)                                                                          \
+    do {                                                                                           \
+        for(size_t croll__seg = 0; croll__seg < CROLL__SEG_MAX && (sa)->segs[croll__seg] != NULL; croll__seg++) { \
+            free((sa)->segs[croll__seg]);                                                          \
+            (sa)->segs[croll__seg] = NULL;                                                         \
+        }                                                                                          \
+        (sa)->len = 0;                                                                             \
+        (sa)->cap = 0;                                                                             \
+    } while(0)
+
 //======================================================================
 // Types
 //======================================================================
@@ -155,11 +369,76 @@ typedef int32_t croll_i32;
 typedef uint32_t croll_u32;
 typedef int64_t croll_i64;
 typedef uint64_t croll_u64;
+typedef float croll_f32;
+typedef double croll_f64;
 
 // helper aliases
 
 typedef croll_u8 croll_byte;
 
+// Non-owning string slice, not null-terminated
+typedef struct croll_StrView {
+    const char *data;
+    size_t len;
+} croll_StrView;
+
+#define croll_sv(cstr) ((croll_StrView){(cstr), strlen(cstr)})
+
+// bit helpers
+
+// Index of the highest set bit, x must not be 0
+static inline size_t croll__log2(size_t x) {
+#if defined(__GNUC__)
+    return sizeof(unsigned long long) * 8 - 1 - (size_t)__builtin_clzll((unsigned long long)x);
+#else
+    size_t r = 0;
+    while (x >>= 1) r++;
+    return r;
+#endif
+}
+
+// Number of trailing zero bits, x must not be 0
+static inline size_t croll__ctz64(croll_u64 x) {
+#if defined(__GNUC__)
+    return (size_t)__builtin_ctzll(x);
+#else
+    size_t r = 0;
+    while (!(x & 1)) { x >>= 1; r++; }
+    return r;
+#endif
+}
+
+static inline size_t croll__popcount64(croll_u64 x) {
+#if defined(__GNUC__)
+    return (size_t)__builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return (size_t)((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+#if defined(__GNUC__)
+    #define CROLL__PREFETCH(p) __builtin_prefetch((p))
+#else
+    #define CROLL__PREFETCH(p) ((void)(p))
+#endif
+
+// 2D grid
+
+// Row-major is the tile_shift == 0 case of the tiled formula
+static inline size_t croll__gridIndex(size_t r, size_t c, size_t stride, size_t ts) {
+    size_t m = ((size_t)1 << ts) - 1;
+    return (((r >> ts) * stride) << ts) + ((c >> ts) << (2 * ts)) + ((r & m) << ts) + (c & m);
+}
+
+// segmented array
+
+static inline size_t croll__segIndex(size_t i) { return croll__log2(i + croll_segBaseCap) - CROLL_SEG_BASE_SHIFT; }
+static inline size_t croll__segOffset(size_t i) { return (i + croll_segBaseCap) - ((size_t)1 << croll__log2(i + croll_segBaseCap)); }
+static inline size_t croll__segCap(size_t seg) { return croll_segBaseCap << seg; }
+
 // string builder
 
 typedef croll_daDecl(char, ) croll_StringBuilder;
@@ -170,14 +449,167 @@ typedef croll_daDecl(char, ) croll_StringBuilder;
 
 // bump allocator
 
-// Aka arena allocator, used as essentially a garbage collector
+// Allocation sizes are bucketed by floor(log2(size)), the last bucket takes everything bigger
+#define CROLL_BUMP_STATS_BUCKETS 32
+
+/**
+ * @struct croll_BumpStats
+ * @brief Usage report of a bump allocator, see croll_bumpStats
+ *
+ * The block fields are always filled, the counters only when CROLL_BUMP_STATS
+ * is defined (otherwise they stay 0 and allocation does no bookkeeping).
+ */
+typedef struct croll_BumpStats {
+    size_t blocks;      // blocks in the chain, side blocks included
+    size_t reserved;    // bytes of all blocks
+    size_t in_use;      // bytes handed out since the last reset
+    size_t tail_waste;  // bytes left unused at the end of blocks the arena moved past
+    size_t requested;   // bytes asked for, summed over every allocation
+    size_t consumed;    // bytes those allocations took, rounding and alignment padding included
+    size_t peak;        // highest in_use seen, across resets
+    size_t allocations;
+    size_t resets;
+    size_t histogram[CROLL_BUMP_STATS_BUCKETS];
+} croll_BumpStats;
+
+// Aka arena allocator, used as essentially a garbage collector.
+// `_current` (head only) is the block allocations come from, blocks after it are empty.
+// `_side` (head only) lists the blocks of requests over CROLL_BUMP_MAX_BLOCK_SIZE, newest first.
 typedef struct croll_BumpAlloc {
     struct croll_BumpAlloc *_next;
+    struct croll_BumpAlloc *_current;
+    struct croll_BumpAlloc *_side;
     croll_byte *data;
     size_t size;
     size_t offset;
+    size_t _block_align; // 0 for plain malloc'd blocks
+#ifdef CROLL_BUMP_STATS
+    croll_BumpStats _stats; // counters, kept on the head only
+    size_t _live;           // bytes consumed since the last reset
+#endif
 } croll_BumpAlloc;
 
+// Largest alignment croll_bumpAllocAligned accepts
+#define CROLL_BUMP_MAX_ALIGN 4096
+
+// A saved arena position, see croll_bumpMark
+typedef struct croll_BumpMark {
+    croll_BumpAlloc *block;
+    size_t offset;
+    croll_BumpAlloc *_side;
+} croll_BumpMark;
+
+/**
+ * @struct croll_BumpTrimPolicy
+ * @brief Moving average of arena usage at reset, used to size what an adaptive reset keeps
+ *
+ * Zero-initialise it, `alpha` (weight of the newest sample) defaults to 1/8
+ * and `headroom` (kept bytes per average byte used) to 1.5.
+ */
+typedef struct croll_BumpTrimPolicy {
+    double avg_used;
+    double alpha;
+    double headroom;
+} croll_BumpTrimPolicy;
+
+// scratch arenas
+
+// First block size of each per-thread scratch arena
+#ifndef CROLL_SCRATCH_SIZE
+    #define CROLL_SCRATCH_SIZE ((size_t)64 * 1024)
+#endif
+
+// Temporary memory on one of the calling thread's two scratch arenas
+typedef struct croll_Scratch {
+    croll_BumpAlloc *arena;
+    croll_BumpMark mark;
+} croll_Scratch;
+
+// Picks a scratch arena that is none of the given arenas (any number, including none),
+// so results can go to a caller's arena, itself possibly a scratch, while temporaries go here.
+// Example use:
+// croll_Scratch tmp = croll_scratchBegin(out_arena);
+// int *work = croll_bumpAllocOrExpand(tmp.arena, n * sizeof(int));
+// ... build the result in out_arena ...
+// croll_scratchEnd(tmp);
+#define croll_scratchBegin(...)                                                     \
+    croll__scratchBegin((croll_BumpAlloc *[]){NULL, __VA_ARGS__} + 1,               \
+                        sizeof((croll_BumpAlloc *[]){NULL, __VA_ARGS__}) / sizeof(croll_BumpAlloc *) - 1)
+
+// concurrent arena
+
+// The concurrent types are built on C11 atomics, which C++ can't spell, so C++ only sees them as opaque handles
+#ifdef __cplusplus
+typedef struct croll_AtomicArena croll_AtomicArena;
+#else
+// Blocks are chained backwards from the newest, the only one allocated from.
+// Blocks for oversized requests are linked in right behind it.
+typedef struct croll__AtomicBlock {
+    _Atomic(struct croll__AtomicBlock *) prev;
+    size_t size;
+    _Atomic size_t offset;
+    croll_byte *data;
+} croll__AtomicBlock;
+
+/**
+ * @struct croll_AtomicArena
+ * @brief Bump arena that any number of threads can allocate from at once
+ *
+ * Allocation is one fetch-add on the current block. The thread that fills a block
+ * swaps in a placeholder with a compare-and-swap and installs the next block, others
+ * wait for it instead of racing to allocate their own. Requests over a quarter of a
+ * block get a block to themselves, linked behind the current one, so they neither
+ * waste its tail nor retire it. Reset and destroy are not thread-safe.
+ */
+typedef struct croll_AtomicArena {
+    _Alignas(CROLL_CACHE_LINE) _Atomic(croll__AtomicBlock *) current;
+    size_t block_size;
+} croll_AtomicArena;
+#endif
+
+// virtual memory arena
+
+// Pages are committed this many bytes at a time (rounded to the page size)
+#ifndef CROLL_VARENA_COMMIT_SIZE
+    #define CROLL_VARENA_COMMIT_SIZE ((size_t)64 * 1024)
+#endif
+
+// croll_varenaNew flag: advise transparent huge pages, base and commits are 2MB aligned
+#define CROLL_VARENA_HUGEPAGES 1
+
+/**
+ * @struct croll_VArena
+ * @brief Bump arena over one reserved address range
+ *
+ * The whole range is reserved up front without backing memory, pages are made
+ * usable as `offset` passes `committed`. Memory never moves and never chains.
+ * Only available where CROLL_HAS_VARENA is defined (POSIX, see the note by its definition).
+ */
+typedef struct croll_VArena {
+    croll_byte *base;
+    size_t reserved;
+    size_t committed;
+    size_t offset;
+    size_t commit_step;
+    int flags;
+} croll_VArena;
+
+#define CROLL__CONCAT_(a, b) a##b
+#define CROLL__CONCAT(a, b) CROLL__CONCAT_(a, b)
+
+// Runs the following block once and rewinds the arena after it, every allocation
+// made inside is released. Leaving the block with break, return or goto skips the rewind.
+// Example use:
+// croll_bumpScope(arena) {
+//     char *tmp = croll_bumpAllocOrExpand(arena, 4096);
+//     ...
+// }
+#define croll_bumpScope(bump)                                                                  \
+    for(croll_BumpMark CROLL__CONCAT(croll__mark, __LINE__) = croll_bumpMark(bump);            \
+        CROLL__CONCAT(croll__mark, __LINE__).block != NULL;                                    \
+        croll_bumpRewind((bump), CROLL__CONCAT(croll__mark, __LINE__)),                        \
+        CROLL__CONCAT(croll__mark, __LINE__).block = NULL)
+
 // A simple pool allocator.
 
 /**
@@ -186,16 +618,310 @@ typedef struct croll_BumpAlloc {
  * 
  * A simple pool allocator.
  * 
- * The allocation is done in O(1) time due to the next free chunk being always available in the `free_chunks` field.
+ * Allocation and free are O(1) however many blocks the pool grew to: freed chunks of
+ * every block go to the head's `free_chunks` list, and chunks never handed out are
+ * carved off the newest block on demand, so a fresh block is not touched up front.
+ *
+ * The head also keeps every block sorted by address, so croll_poolOwns finds the
+ * block a pointer falls in with a binary search.
  */
 typedef struct croll_PoolAlloc {
-    struct croll_PoolAlloc *_next;
-    void *free_chunks;
+    struct croll_PoolAlloc *_next; // blocks added by growth, newest first
+    void *free_chunks;             // head only
     void *chunks;
+    croll_byte *_carve;            // head only, next never-used chunk of the newest block
+    croll_byte *_carve_end;
+    croll_daDecl(struct croll_PoolAlloc *, ) _blocks; // head only, sorted by `chunks`
     size_t chunk_size;
-    size_t size;
+    size_t size;                   // chunks per block
 } croll_PoolAlloc;
 
+// croll_poolFree checks ownership when this is defined or assertions are on
+#if defined(CROLL_POOL_VALIDATE) || !defined(NDEBUG)
+    #define CROLL__POOL_VALIDATE 1
+#endif
+
+// ring buffer
+
+#ifdef __cplusplus
+typedef struct croll_Ring croll_Ring;
+#else
+/**
+ * @struct croll_Ring
+ * @brief Lock-free single-producer/single-consumer FIFO
+ *
+ * Fixed power-of-two capacity, elements are copied in and out by value.
+ * The consumer owns `head` and the producer owns `tail`, each on its own cache line.
+ * Both sides keep a cached copy of the other side's index and only read the shared
+ * one when the cached copy says the ring is full (or empty), so a batch push/pop
+ * costs a single cache-line exchange.
+ */
+typedef struct croll_Ring {
+    _Alignas(CROLL_CACHE_LINE) _Atomic size_t head;
+    size_t _tail_cache;
+
+    _Alignas(CROLL_CACHE_LINE) _Atomic size_t tail;
+    size_t _head_cache;
+
+    _Alignas(CROLL_CACHE_LINE) croll_byte *data;
+    size_t mask;
+    size_t elem_size;
+} croll_Ring;
+#endif
+
+// MPMC queue
+
+#ifdef __cplusplus
+typedef struct croll_MpmcQueue croll_MpmcQueue;
+#else
+/**
+ * @struct croll_MpmcQueue
+ * @brief Bounded lock-free multi-producer/multi-consumer FIFO
+ *
+ * Dmitry Vyukov's bounded queue: every cell carries a sequence number that tells
+ * producers and consumers whether it is theirs to fill or drain, so each operation
+ * is one CAS on the shared position plus a copy.
+ * The positions and the futex words used by the blocking variants each live on their own cache line.
+ */
+typedef struct croll_MpmcQueue {
+    _Alignas(CROLL_CACHE_LINE) _Atomic size_t enqueue_pos;
+    _Alignas(CROLL_CACHE_LINE) _Atomic size_t dequeue_pos;
+
+    // bumped (and waited on) when a push lands while consumers are parked
+    _Alignas(CROLL_CACHE_LINE) _Atomic croll_u32 _not_empty;
+    _Atomic croll_u32 _pop_waiters;
+    // bumped (and waited on) when a pop lands while producers are parked
+    _Alignas(CROLL_CACHE_LINE) _Atomic croll_u32 _not_full;
+    _Atomic croll_u32 _push_waiters;
+
+    _Alignas(CROLL_CACHE_LINE) croll_byte *cells;
+    size_t mask;
+    size_t elem_size;
+    size_t cell_size;
+} croll_MpmcQueue;
+#endif
+
+// heap
+
+typedef struct croll_HeapNode {
+    croll_u64 key;
+    croll_u64 value;
+} croll_HeapNode;
+
+/**
+ * @struct croll_Heap
+ * @brief d-ary min-heap priority queue stored in a dynamic array
+ *
+ * Zero-initialize it to get a 4-ary heap (`croll_Heap heap = {0};`), a node's children then share
+ * a cache line, or set `arity` (a power of two) before the first push.
+ * Set `indexed` to true to track where each value sits in `positions`, which croll_heapDecreaseKey needs.
+ * Values are then dense ids used to index that array.
+ * For a max-heap push `~key`.
+ */
+typedef struct croll_Heap {
+    croll_daDecl(croll_HeapNode, ) nodes;
+    croll_daDecl(size_t, ) positions; // value -> index into nodes, SIZE_MAX when absent
+    size_t arity;
+    bool indexed;
+} croll_Heap;
+
+// bitset
+
+/**
+ * @struct croll_Bitset
+ * @brief Fixed-size set of bits packed in 64-bit words
+ *
+ * Bits past `nbits` in the last word are always zero.
+ * `_rank` is the optional rank/select index built by croll_bitsetBuildRank,
+ * it holds the number of set bits before every 512-bit block and goes stale when bits change.
+ */
+typedef struct croll_Bitset {
+    croll_u64 *words;
+    size_t nbits;
+    size_t nwords;
+    croll_u64 *_rank;
+} croll_Bitset;
+
+// search array
+
+/**
+ * @struct croll_SearchArray
+ * @brief Read-only sorted set of u64 keys stored in Eytzinger (BFS) order
+ *
+ * `keys` is 1-indexed and cache-line aligned so the 8 great-grandchildren of node k
+ * share one cache line, keys[0] is a dummy. `rank[k]` maps node k back to its
+ * position in the sorted input, so searches return sorted indices.
+ */
+typedef struct croll_SearchArray {
+    croll_u64 *keys;
+    size_t *rank;
+    size_t len;
+} croll_SearchArray;
+
+// B+tree
+
+/**
+ * @struct croll_BTree
+ * @brief Ordered map from u64 or string keys to values
+ *
+ * Nodes hold up to 15 keys (about four cache lines) and come from a pool,
+ * leaves are linked for range scans. String trees copy their keys into the
+ * `str_keys` arena. There is no removal.
+ */
+typedef struct croll_BTree {
+    struct croll__BTreeNode *root;
+    croll_PoolAlloc *nodes;
+    croll_BumpAlloc *str_keys; // NULL for u64 keys
+    size_t len;
+    size_t height;
+} croll_BTree;
+
+/**
+ * @struct croll_BTreeIter
+ * @brief Forward cursor over a croll_BTree
+ *
+ * `key` (u64 trees) or `str` (string trees) and `value` are filled by croll_btreeNext.
+ * String keys stay valid until the tree is destroyed.
+ */
+typedef struct croll_BTreeIter {
+    struct croll__BTreeNode *_leaf;
+    size_t _i;
+    bool _str;
+    croll_u64 key;
+    croll_StrView str;
+    void *value;
+} croll_BTreeIter;
+
+// adaptive radix tree
+
+/**
+ * @struct croll_Art
+ * @brief Adaptive radix tree from byte-string keys to values
+ *
+ * Inner nodes grow through 4, 16, 48 and 256 child variants, each from its own pool,
+ * and store up to 8 bytes of compressed path. Leaves are copied into the `leaves` arena.
+ */
+typedef struct croll_Art {
+    void *root;
+    croll_PoolAlloc *pools[4];
+    croll_BumpAlloc *leaves;
+    size_t len;
+    size_t _nodes[4];
+    size_t _leaf_bytes;
+} croll_Art;
+
+/**
+ * @struct croll_ArtStats
+ * @brief Memory use of a croll_Art, node arrays indexed Node4, Node16, Node48, Node256
+ */
+typedef struct croll_ArtStats {
+    size_t nodes[4];
+    size_t node_bytes[4];
+    size_t leaves;
+    size_t leaf_bytes;
+} croll_ArtStats;
+
+// Prefix iteration callback, return false to stop
+typedef bool (*croll_ArtVisit)(croll_StrView key, void *value, void *user);
+
+// slot map
+
+// Handles pack {index, generation}, 32/32 bits or 20/12 bits with CROLL_SLOTMAP_HANDLE32.
+// Generation 0 is never handed out, so CROLL_SLOT_NULL (0) is never valid.
+#ifdef CROLL_SLOTMAP_HANDLE32
+typedef croll_u32 croll_SlotHandle;
+#define CROLL__SLOT_INDEX_BITS 20
+#else
+typedef croll_u64 croll_SlotHandle;
+#define CROLL__SLOT_INDEX_BITS 32
+#endif
+#define CROLL__SLOT_GEN_BITS (sizeof(croll_SlotHandle) * 8 - CROLL__SLOT_INDEX_BITS)
+#define CROLL_SLOT_NULL ((croll_SlotHandle)0)
+
+// A slot points at its object in `data` while live, or at the next free slot
+typedef struct croll__Slot {
+    croll_u32 gen;
+    croll_u32 index;
+} croll__Slot;
+
+/**
+ * @struct croll_SlotMap
+ * @brief Dense object storage addressed by generational handles
+ *
+ * Live objects are packed at the front of `data` (`len` of them) and may move on removal,
+ * handles stay stable and go stale once their object is removed.
+ */
+typedef struct croll_SlotMap {
+    croll_byte *data;
+    size_t len;
+    size_t cap;
+    size_t elem_size;
+    croll_daDecl(croll_u32, ) dense_slot; // data index -> slot
+    croll_daDecl(croll__Slot, ) slots;
+    croll_u32 free_head;
+} croll_SlotMap;
+
+// packed array
+
+/**
+ * @struct croll_PackedArray
+ * @brief Unsigned integers of a fixed bit width (1..32) packed back to back
+ *
+ * Built either at a fixed width with croll_packedNew, or by appending to `staging`
+ * and calling croll_packedFreeze, which picks the narrowest width that fits.
+ * `words` carries 32 bytes of zeroed padding so reads can run past the end.
+ */
+typedef struct croll_PackedArray {
+    croll_u64 *words;
+    size_t len;
+    croll_u32 bits; // 0 until frozen
+    croll_daDecl(croll_u32, ) staging;
+} croll_PackedArray;
+
+// compressed integer sequences
+
+#define CROLL_INTSEQ_BLOCK 128
+
+typedef enum croll_IntSeqCodec {
+    CROLL_INTSEQ_VARINT, // delta + LEB128 varint
+    CROLL_INTSEQ_FOR,    // frame of reference, bit-packed relative to each block's first value
+} croll_IntSeqCodec;
+
+// Skip entry for one block of CROLL_INTSEQ_BLOCK values
+typedef struct croll__IntSeqSkip {
+    croll_u64 first;
+    size_t offset; // into data
+    croll_u32 bits; // FOR width
+    croll_u32 count;
+} croll__IntSeqSkip;
+
+/**
+ * @struct croll_IntSeq
+ * @brief Compressed non-decreasing sequence of u64 values
+ *
+ * Values are cut in blocks of CROLL_INTSEQ_BLOCK, each with a skip entry
+ * holding its first value, so seeking only decodes the block it lands in.
+ */
+typedef struct croll_IntSeq {
+    croll_daDecl(croll_byte, ) data;
+    croll_daDecl(croll__IntSeqSkip, ) skips;
+    size_t len;
+    croll_IntSeqCodec codec;
+} croll_IntSeq;
+
+/**
+ * @struct croll_IntSeqIter
+ * @brief Cursor over a croll_IntSeq, decodes one block at a time into `_buf`
+ */
+typedef struct croll_IntSeqIter {
+    const croll_IntSeq *seq;
+    size_t _block;
+    size_t _pos;
+    size_t _count;
+    croll_u64 value;
+    croll_u64 _buf[CROLL_INTSEQ_BLOCK];
+} croll_IntSeqIter;
+
 // hashtable
 
 struct croll_HtEntry {
@@ -255,6 +981,9 @@ typedef struct {
 //======================================================================
 #if defined(CROLL_STRIP_PREFIX) || defined(CROLL_STRIP_DA)
 #define daDecl(type,name)      croll_daDecl(type,name)
+#define daDeclInline(type,name,n) croll_daDeclInline(type,name,n)
+#define daInlineInit(da)       croll_daInlineInit(da)
+#define daInlineReset(da)      croll_daInlineReset(da)
 #define daFree(da)             croll_daFree(da)
 #define daReserve(da,n)        croll_daReserve(da,n)
 #define daAppend(da,x)         croll_daAppend(da,x)
@@ -262,6 +991,16 @@ typedef struct {
 #define daLast(da)             croll_daLast(da)
 #define daForEach(type,it,da)  croll_daForEach(type,it,da)
 #define daIndex(it,da)         croll_daForEach_index(it,da)
+#define daMin(da)              croll_daMin(da)
+#define daMax(da)              croll_daMax(da)
+#define daSum(da)              croll_daSum(da)
+#define daArgMax(da)           croll_daArgMax(da)
+#define daCount(da,x)          croll_daCount(da,x)
+#define soaDecl(name,fields)   croll_soaDecl(name,fields)
+#define soaReserve(name,soa,n) croll_soaReserve(name,soa,n)
+#define soaAppend(name,soa,...) croll_soaAppend(name,soa,__VA_ARGS__)
+#define soaGet(name,soa,i)     croll_soaGet(name,soa,i)
+#define soaFree(name,soa)      croll_soaFree(name,soa)
 #endif
 
 //======================================================================
@@ -281,6 +1020,36 @@ typedef struct {
 #define bumpNew(cap)        croll_bumpNew(cap)
 #define bumpAlloc(bump,n)   croll_bumpAlloc(bump,n)
 #define bumpAllocOrExpand(bump,n) croll_bumpAllocOrExpand(bump,n)
+#define bumpNewAligned(cap,align) croll_bumpNewAligned(cap,align)
+#define BumpMark            croll_BumpMark
+#define bumpMark(bump)      croll_bumpMark(bump)
+#define bumpRewind(bump,mark) croll_bumpRewind(bump,mark)
+#define bumpScope(bump)     croll_bumpScope(bump)
+#define BumpTrimPolicy      croll_BumpTrimPolicy
+#define BumpStats           croll_BumpStats
+#define bumpStats(bump)     croll_bumpStats(bump)
+#define AtomicArena         croll_AtomicArena
+#define atomicArenaNew(cap) croll_atomicArenaNew(cap)
+#define atomicArenaAlloc(arena,n) croll_atomicArenaAlloc(arena,n)
+#define atomicArenaReset(arena) croll_atomicArenaReset(arena)
+#define atomicArenaDestroy(arena) croll_atomicArenaDestroy(arena)
+#define Scratch             croll_Scratch
+#define scratchBegin(...)   croll_scratchBegin(__VA_ARGS__)
+#define scratchEnd(scratch) croll_scratchEnd(scratch)
+#define scratchRelease()    croll_scratchRelease()
+#define bumpResetTrim(bump,keep) croll_bumpResetTrim(bump,keep)
+#define bumpResetAdaptive(bump,policy) croll_bumpResetAdaptive(bump,policy)
+#define bumpTrimPolicyUpdate(policy,used) croll_bumpTrimPolicyUpdate(policy,used)
+#define VArena              croll_VArena
+#define varenaNew(reserve,flags) croll_varenaNew(reserve,flags)
+#define varenaAlloc(va,n)   croll_varenaAlloc(va,n)
+#define varenaAllocAligned(va,n,align) croll_varenaAllocAligned(va,n,align)
+#define varenaReset(va)     croll_varenaReset(va)
+#define varenaResetTrim(va,keep) croll_varenaResetTrim(va,keep)
+#define varenaResetAdaptive(va,policy) croll_varenaResetAdaptive(va,policy)
+#define varenaDestroy(va)   croll_varenaDestroy(va)
+#define bumpAllocAligned(bump,n,align) croll_bumpAllocAligned(bump,n,align)
+#define bumpAllocAlignedOrExpand(bump,n,align) croll_bumpAllocAlignedOrExpand(bump,n,align)
 #define bumpReset(bump)     croll_bumpReset(bump)
 #define bumpDestroy(bump)   croll_bumpDestroy(bump)
 #endif
@@ -293,6 +1062,7 @@ typedef struct {
 #define poolAlloc(pool)         croll_poolAlloc(pool)
 #define poolFree(pool,chunk)    croll_poolFree(pool,chunk)
 #define poolDestroy(pool)       croll_poolDestroy(pool)
+#define poolOwns(pool,ptr)      croll_poolOwns(pool,ptr)
 #endif
 
 //======================================================================
@@ -324,9 +1094,189 @@ typedef struct {
 #define u32  croll_u32
 #define i64  croll_i64
 #define u64  croll_u64
+#define f32  croll_f32
+#define f64  croll_f64
 #define byte croll_byte
+#define StrView croll_StrView
+#define sv(cstr) croll_sv(cstr)
 #endif 
 
+//======================================================================
+// 12. Segmented Array / Grid
+//======================================================================
+#if defined(CROLL_STRIP_PREFIX) || defined(CROLL_STRIP_SEG) || defined(CROLL_STRIP_GRID)
+#define gridDecl(type,name)    croll_gridDecl(type,name)
+#define gridInit(g,r,c)        croll_gridInit(g,r,c)
+#define gridInitTiled(g,r,c,s) croll_gridInitTiled(g,r,c,s)
+#define gridFree(g)            croll_gridFree(g)
+#define gridAt(g,r,c)          croll_gridAt(g,r,c)
+#define gridRow(g,r)           croll_gridRow(g,r)
+#define gridForEachInRow(type,it,g,r) croll_gridForEachInRow(type,it,g,r)
+#define gridForEachInCol(type,it,g,c) croll_gridForEachInCol(type,it,g,c)
+#define gridTranspose(dst,src) croll_gridTranspose(dst,src)
+#define segDecl(type,name)     croll_segDecl(type,name)
+#define segAt(sa,i)            croll_segAt(sa,i)
+#define segReserve(sa,n)       croll_segReserve(sa,n)
+#define segAppend(sa,x)        croll_segAppend(sa,x)
+#define segLast(sa)            croll_segLast(sa)
+#define segFree(sa)            croll_segFree(sa)
+#endif
+
+//======================================================================
+// 13. Ring Buffer
+//======================================================================
+#if defined(CROLL_STRIP_PREFIX) || defined(CROLL_STRIP_RING)
+#define ringNew(cap,elemSz)         croll_ringNew(cap,elemSz)
+#define ringPush(ring,item)         croll_ringPush(ring,item)
+#define ringPop(ring,out)           croll_ringPop(ring,out)
+#define ringPushBatch(ring,items,n) croll_ringPushBatch(ring,items,n)
+#define ringPopBatch(ring,out,n)    croll_ringPopBatch(ring,out,n)
+#define ringLen(ring)               croll_ringLen(ring)
+#define ringDestroy(ring)           croll_ringDestroy(ring)
+#endif
+
+//======================================================================
+// 14. MPMC Queue
+//======================================================================
+#if defined(CROLL_STRIP_PREFIX) || defined(CROLL_STRIP_MPMC)
+#define mpmcNew(cap,elemSz)   croll_mpmcNew(cap,elemSz)
+#define mpmcTryPush(q,item)   croll_mpmcTryPush(q,item)
+#define mpmcTryPop(q,out)     croll_mpmcTryPop(q,out)
+#define mpmcPush(q,item)      croll_mpmcPush(q,item)
+#define mpmcPop(q,out)        croll_mpmcPop(q,out)
+#define mpmcDestroy(q)        croll_mpmcDestroy(q)
+#endif
+
+//======================================================================
+// 15. Heap
+//======================================================================
+#if defined(CROLL_STRIP_PREFIX) || defined(CROLL_STRIP_HEAP)
+#define heapPush(heap,key,val)        croll_heapPush(heap,key,val)
+#define heapPeek(heap)                croll_heapPeek(heap)
+#define heapPop(heap)                 croll_heapPop(heap)
+#define heapify(heap)                 croll_heapify(heap)
+#define heapContains(heap,val)        croll_heapContains(heap,val)
+#define heapDecreaseKey(heap,val,key) croll_heapDecreaseKey(heap,val,key)
+#define heapFree(heap)                croll_heapFree(heap)
+#endif
+
+//======================================================================
+// 16. Bitset
+//======================================================================
+#if defined(CROLL_STRIP_PREFIX) || defined(CROLL_STRIP_BITSET)
+#define bitsetNew(nbits)         croll_bitsetNew(nbits)
+#define bitsetSet(bs,i)          croll_bitsetSet(bs,i)
+#define bitsetClear(bs,i)        croll_bitsetClear(bs,i)
+#define bitsetTest(bs,i)         croll_bitsetTest(bs,i)
+#define bitsetAnd(dst,a,b)       croll_bitsetAnd(dst,a,b)
+#define bitsetOr(dst,a,b)        croll_bitsetOr(dst,a,b)
+#define bitsetXor(dst,a,b)       croll_bitsetXor(dst,a,b)
+#define bitsetAndNot(dst,a,b)    croll_bitsetAndNot(dst,a,b)
+#define bitsetCount(bs)          croll_bitsetCount(bs)
+#define bitsetNext(bs,from)      croll_bitsetNext(bs,from)
+#define bitsetBuildRank(bs)      croll_bitsetBuildRank(bs)
+#define bitsetRank(bs,i)         croll_bitsetRank(bs,i)
+#define bitsetSelect(bs,k)       croll_bitsetSelect(bs,k)
+#define bitsetFree(bs)           croll_bitsetFree(bs)
+#endif
+
+//======================================================================
+// 17. Search Array
+//======================================================================
+#if defined(CROLL_STRIP_PREFIX) || defined(CROLL_STRIP_SEARCH)
+#define SearchArray                   croll_SearchArray
+#define searchNew(sorted,len)         croll_searchNew(sorted,len)
+#define searchFromDa(da)              croll_searchFromDa(da)
+#define searchLowerBound(sa,key)      croll_searchLowerBound(sa,key)
+#define searchUpperBound(sa,key)      croll_searchUpperBound(sa,key)
+#define searchContains(sa,key)        croll_searchContains(sa,key)
+#define searchLowerBoundBatch(sa,keys,count,out) croll_searchLowerBoundBatch(sa,keys,count,out)
+#define searchFree(sa)                croll_searchFree(sa)
+#endif
+
+//======================================================================
+// 18. B+tree
+//======================================================================
+#if defined(CROLL_STRIP_PREFIX) || defined(CROLL_STRIP_BTREE)
+#define BTree                              croll_BTree
+#define BTreeIter                          croll_BTreeIter
+#define btreeNew()                         croll_btreeNew()
+#define btreeNewStr()                      croll_btreeNewStr()
+#define btreeSet(tree,key,value)           croll_btreeSet(tree,key,value)
+#define btreeGet(tree,key)                 croll_btreeGet(tree,key)
+#define btreeSetStr(tree,key,value)        croll_btreeSetStr(tree,key,value)
+#define btreeGetStr(tree,key)              croll_btreeGetStr(tree,key)
+#define btreeBulkLoad(tree,keys,values,len)    croll_btreeBulkLoad(tree,keys,values,len)
+#define btreeBulkLoadStr(tree,keys,values,len) croll_btreeBulkLoadStr(tree,keys,values,len)
+#define btreeFirst(tree)                   croll_btreeFirst(tree)
+#define btreeSeek(tree,key)                croll_btreeSeek(tree,key)
+#define btreeSeekStr(tree,key)             croll_btreeSeekStr(tree,key)
+#define btreeNext(it)                      croll_btreeNext(it)
+#define btreeDestroy(tree)                 croll_btreeDestroy(tree)
+#endif
+
+//======================================================================
+// 19. Adaptive Radix Tree
+//======================================================================
+#if defined(CROLL_STRIP_PREFIX) || defined(CROLL_STRIP_ART)
+#define Art                            croll_Art
+#define ArtStats                       croll_ArtStats
+#define ArtVisit                       croll_ArtVisit
+#define artNew()                       croll_artNew()
+#define artSet(art,key,value)          croll_artSet(art,key,value)
+#define artGet(art,key)                croll_artGet(art,key)
+#define artIterPrefix(art,prefix,fn,user) croll_artIterPrefix(art,prefix,fn,user)
+#define artStats(art)                  croll_artStats(art)
+#define artDestroy(art)                croll_artDestroy(art)
+#endif
+
+//======================================================================
+// 20. Slot Map
+//======================================================================
+#if defined(CROLL_STRIP_PREFIX) || defined(CROLL_STRIP_SLOTMAP)
+#define SlotMap                        croll_SlotMap
+#define SlotHandle                     croll_SlotHandle
+#define SLOT_NULL                      CROLL_SLOT_NULL
+#define slotmapNew(elem_size)          croll_slotmapNew(elem_size)
+#define slotmapInsert(sm,elem)         croll_slotmapInsert(sm,elem)
+#define slotmapGet(sm,h)               croll_slotmapGet(sm,h)
+#define slotmapValid(sm,h)             croll_slotmapValid(sm,h)
+#define slotmapRemove(sm,h)            croll_slotmapRemove(sm,h)
+#define slotmapHandleAt(sm,i)          croll_slotmapHandleAt(sm,i)
+#define slotmapForEach(type,it,sm)     croll_slotmapForEach(type,it,sm)
+#define slotmapFree(sm)                croll_slotmapFree(sm)
+#endif
+
+//======================================================================
+// 21. Packed Array
+//======================================================================
+#if defined(CROLL_STRIP_PREFIX) || defined(CROLL_STRIP_PACKED)
+#define PackedArray                    croll_PackedArray
+#define packedNew(len,bits)            croll_packedNew(len,bits)
+#define packedAppend(pa,value)         croll_packedAppend(pa,value)
+#define packedFreeze(pa)               croll_packedFreeze(pa)
+#define packedGet(pa,i)                croll_packedGet(pa,i)
+#define packedSet(pa,i,value)          croll_packedSet(pa,i,value)
+#define packedUnpack(pa,start,count,out) croll_packedUnpack(pa,start,count,out)
+#define packedFree(pa)                 croll_packedFree(pa)
+#endif
+
+//======================================================================
+// 22. Integer Sequences
+//======================================================================
+#if defined(CROLL_STRIP_PREFIX) || defined(CROLL_STRIP_INTSEQ)
+#define IntSeq                         croll_IntSeq
+#define IntSeqIter                     croll_IntSeqIter
+#define intseqEncode(seq,sorted,len,codec) croll_intseqEncode(seq,sorted,len,codec)
+#define intseqFromDa(seq,da,codec)     croll_intseqFromDa(seq,da,codec)
+#define intseqDecode(seq,out)          croll_intseqDecode(seq,out)
+#define intseqIterInit(it,seq)         croll_intseqIterInit(it,seq)
+#define intseqNext(it)                 croll_intseqNext(it)
+#define intseqSeek(it,target)          croll_intseqSeek(it,target)
+#define intseqIntersect(a,b,out)       croll_intseqIntersect(a,b,out)
+#define intseqFree(seq)                croll_intseqFree(seq)
+#endif
+
 //======================================================================
 // Declaration of functions
 //======================================================================
@@ -432,6 +1382,38 @@ __STATIC_FUNCTION bool croll_SgetLine(char *buffer, size_t buffer_size);
  */
 __STATIC_FUNCTION croll_StringBuilder croll_readEntireFile(const char *path);
 
+//======================================================================
+// Dynamic Array Reductions
+//======================================================================
+/**
+ * @brief Type-specialized reductions behind croll_daMin/Max/Sum/Count/ArgMax.
+ *
+ * One set exists per element type (suffixes I32, U32, I64, U64, F32, F64).
+ * They use AVX2 or SSE4.2 when the running CPU has it, with several
+ * accumulators in flight, and fall back to scalar code otherwise.
+ * Sums of 32-bit integers are widened to 64 bits, and the order in which
+ * float sums are added is unspecified. Float Min / Max / ArgMax skip NaN
+ * elements (like fmin / fmax) and only return NaN when every element is NaN,
+ * with or without SIMD.
+ *
+ * Min / Max   Smallest / largest element (len must be > 0).
+ * Sum         Sum of all elements.
+ * Count       Number of elements equal to value.
+ * ArgMax      Index of the first largest element (len must be > 0).
+ */
+#define CROLL__DA_REDUCE_DECL(sfx, T, S)                                                 \
+    __STATIC_FUNCTION T croll_daMin##sfx(const T *data, size_t len);                     \
+    __STATIC_FUNCTION T croll_daMax##sfx(const T *data, size_t len);                     \
+    __STATIC_FUNCTION S croll_daSum##sfx(const T *data, size_t len);                     \
+    __STATIC_FUNCTION size_t croll_daCount##sfx(const T *data, size_t len, T value);     \
+    __STATIC_FUNCTION size_t croll_daArgMax##sfx(const T *data, size_t len);
+CROLL__DA_REDUCE_DECL(I32, croll_i32, croll_i64)
+CROLL__DA_REDUCE_DECL(U32, croll_u32, croll_u64)
+CROLL__DA_REDUCE_DECL(I64, croll_i64, croll_i64)
+CROLL__DA_REDUCE_DECL(U64, croll_u64, croll_u64)
+CROLL__DA_REDUCE_DECL(F32, croll_f32, croll_f32)
+CROLL__DA_REDUCE_DECL(F64, croll_f64, croll_f64)
+
 //======================================================================
 // Memory Allocators
 //======================================================================
@@ -443,6 +1425,17 @@ __STATIC_FUNCTION croll_StringBuilder croll_readEntireFile(const char *path);
  */
 __STATIC_FUNCTION croll_BumpAlloc *croll_bumpNew(size_t capacity);
 
+/**
+ * @brief Creates a bump allocator whose blocks start on a block_align boundary.
+ *
+ * Blocks chained later keep the same alignment, e.g. 64 for cache-line aligned blocks.
+ *
+ * @param capacity    Size of the first block in bytes.
+ * @param block_align Power of two up to CROLL_BUMP_MAX_ALIGN.
+ * @return            Pointer to allocator or NULL on failure.
+ */
+__STATIC_FUNCTION croll_BumpAlloc *croll_bumpNewAligned(size_t capacity, size_t block_align);
+
 /**
  * @brief Allocates memory from a bump allocator.
  *
@@ -452,6 +1445,33 @@ __STATIC_FUNCTION croll_BumpAlloc *croll_bumpNew(size_t capacity);
  */
 __STATIC_FUNCTION void *croll_bumpAlloc(croll_BumpAlloc *bump, size_t size);
 
+/**
+ * @brief Allocates memory, chaining a new block when the current one is full.
+ *
+ * New blocks double in size up to CROLL_BUMP_MAX_BLOCK_SIZE (or the request size if larger),
+ * and allocation always starts from the current block, so it stays O(1) however long the chain gets.
+ * A request over CROLL_BUMP_MAX_BLOCK_SIZE gets a side block of its own, which leaves the current
+ * block and the growth alone and is freed at the next reset (or rewind past it).
+ *
+ * @param bump Pointer to bump allocator.
+ * @param size Number of bytes to allocate.
+ * @return     Pointer to memory or NULL on allocation failure.
+ */
+__STATIC_FUNCTION void *croll_bumpAllocOrExpand(croll_BumpAlloc *bump, size_t size);
+
+/**
+ * @brief Allocates memory starting on an align boundary.
+ *
+ * The OrExpand variant chains a new block when the current one is full.
+ *
+ * @param bump  Pointer to bump allocator.
+ * @param size  Number of bytes to allocate.
+ * @param align Power of two up to CROLL_BUMP_MAX_ALIGN.
+ * @return      Pointer to memory or NULL if out of space.
+ */
+__STATIC_FUNCTION void *croll_bumpAllocAligned(croll_BumpAlloc *bump, size_t size, size_t align);
+__STATIC_FUNCTION void *croll_bumpAllocAlignedOrExpand(croll_BumpAlloc *bump, size_t size, size_t align);
+
 /**
  * @brief Resets a bump allocator (frees all in one go).
  *
@@ -460,32 +1480,213 @@ __STATIC_FUNCTION void *croll_bumpAlloc(croll_BumpAlloc *bump, size_t size);
 __STATIC_FUNCTION void croll_bumpReset(croll_BumpAlloc *bump);
 
 /**
- * @brief Destroys a bump allocator and frees its memory.
+ * @brief Saves the current arena position.
  *
  * @param bump Pointer to bump allocator.
+ * @return     Position to hand to croll_bumpRewind.
  */
-__STATIC_FUNCTION void croll_bumpDestroy(croll_BumpAlloc *bump);
+__STATIC_FUNCTION croll_BumpMark croll_bumpMark(croll_BumpAlloc *bump);
 
 /**
- * @brief Creates a new pool allocator.
+ * @brief Resets a bump allocator and frees chained blocks past a budget.
  *
- * @param pool_size  Number of chunks.
- * @param chunk_size Size of each chunk (>= sizeof(void*)).
- * @return           Pointer to allocator or NULL on failure.
+ * Blocks are kept from the head on while their total size stays within keep_bytes,
+ * the head block is always kept.
+ *
+ * @param bump       Pointer to bump allocator.
+ * @param keep_bytes Bytes of blocks to keep.
  */
-__STATIC_FUNCTION croll_PoolAlloc *croll_poolNew(size_t pool_size, size_t chunk_size);
+__STATIC_FUNCTION void croll_bumpResetTrim(croll_BumpAlloc *bump, size_t keep_bytes);
 
 /**
- * @brief Allocates one chunk from the pool.
+ * @brief Feeds one usage sample to a trim policy.
  *
- * @param pool Pointer to pool allocator.
- * @return     Pointer to chunk or NULL if error.
+ * @param policy Pointer to policy.
+ * @param used   Bytes in use at this reset.
+ * @return       Bytes to keep, the moving average times the headroom.
  */
-__STATIC_FUNCTION void *croll_poolAlloc(croll_PoolAlloc *pool);
+__STATIC_FUNCTION size_t croll_bumpTrimPolicyUpdate(croll_BumpTrimPolicy *policy, size_t used);
+
+/**
+ * @brief Resets a bump allocator keeping what the policy says typical load needs.
+ *
+ * A single spike only moves the average a little, so its blocks are freed
+ * at the next reset instead of being held forever.
+ *
+ * @param bump   Pointer to bump allocator.
+ * @param policy Pointer to policy, one per arena.
+ */
+__STATIC_FUNCTION void croll_bumpResetAdaptive(croll_BumpAlloc *bump, croll_BumpTrimPolicy *policy);
+
+/**
+ * @brief Frees everything allocated since mark was taken.
+ *
+ * Blocks chained since then are kept (empty) for reuse, side blocks made
+ * since then (see croll_bumpAllocOrExpand) are freed. Marks taken after
+ * this one become invalid, and so does every mark once the arena is reset
+ * (croll_bumpReset / ResetTrim / ResetAdaptive): rewinding to one then asserts,
+ * or after a trim touches freed memory.
+ *
+ * @param bump Pointer to bump allocator.
+ * @param mark Position from croll_bumpMark on the same arena.
+ */
+__STATIC_FUNCTION void croll_bumpRewind(croll_BumpAlloc *bump, croll_BumpMark mark);
+
+/**
+ * @brief Reports block usage and, with CROLL_BUMP_STATS defined, allocation counters.
+ *
+ * Walks the block chain, so it is meant for occasional sampling, not hot paths.
+ *
+ * @param bump Pointer to bump allocator (the head).
+ * @return     Usage report.
+ */
+__STATIC_FUNCTION croll_BumpStats croll_bumpStats(croll_BumpAlloc *bump);
+
+/**
+ * @brief Destroys a bump allocator and frees its memory.
+ *
+ * @param bump Pointer to bump allocator.
+ */
+__STATIC_FUNCTION void croll_bumpDestroy(croll_BumpAlloc *bump);
+
+/**
+ * @brief Creates a concurrent bump arena.
+ *
+ * @param block_size Size of each block in bytes, requests over a quarter of it get a block their size.
+ * @return           Pointer to arena or NULL on failure.
+ */
+__STATIC_FUNCTION croll_AtomicArena *croll_atomicArenaNew(size_t block_size);
+
+/**
+ * @brief Allocates memory, safe to call from many threads at once.
+ *
+ * @param arena Pointer to arena.
+ * @param size  Number of bytes to allocate (rounded up to 8).
+ * @return      Pointer to memory or NULL on allocation failure.
+ */
+__STATIC_FUNCTION void *croll_atomicArenaAlloc(croll_AtomicArena *arena, size_t size);
+
+/**
+ * @brief Frees everything but the newest block, no thread may be allocating.
+ *
+ * @param arena Pointer to arena.
+ */
+__STATIC_FUNCTION void croll_atomicArenaReset(croll_AtomicArena *arena);
+
+/**
+ * @brief Destroys a concurrent arena, no thread may be allocating.
+ *
+ * @param arena Pointer to arena.
+ */
+__STATIC_FUNCTION void croll_atomicArenaDestroy(croll_AtomicArena *arena);
+
+/**
+ * @brief Backs croll_scratchBegin.
+ *
+ * Creates the thread's scratch arenas on first use, after that it never mallocs.
+ *
+ * @param conflicts Arenas the scratch must not be.
+ * @param count     Number of conflicts.
+ * @return          The chosen arena and a mark to rewind it to.
+ */
+__STATIC_FUNCTION croll_Scratch croll__scratchBegin(croll_BumpAlloc *const *conflicts, size_t count);
+
+/**
+ * @brief Frees everything allocated from a scratch since croll_scratchBegin.
+ *
+ * Scratches must end in reverse order of their begin.
+ */
+__STATIC_FUNCTION void croll_scratchEnd(croll_Scratch scratch);
+
+/**
+ * @brief Destroys the calling thread's scratch arenas, call it before the thread exits.
+ */
+__STATIC_FUNCTION void croll_scratchRelease(void);
+
+#ifdef CROLL_HAS_VARENA
+/**
+ * @brief Reserves an address range for a virtual memory arena.
+ *
+ * @param reserve Bytes of address space to reserve (e.g. 1 << 36), nothing is committed yet.
+ * @param flags   0 or CROLL_VARENA_HUGEPAGES.
+ * @return        Pointer to arena or NULL on failure.
+ */
+__STATIC_FUNCTION croll_VArena *croll_varenaNew(size_t reserve, int flags);
+
+/**
+ * @brief Allocates from the arena, committing pages as needed.
+ *
+ * @param va    Pointer to arena.
+ * @param size  Number of bytes to allocate.
+ * @param align Power of two up to the page size (croll_varenaAlloc uses 8).
+ * @return      Pointer to memory or NULL once the reservation is used up.
+ */
+__STATIC_FUNCTION void *croll_varenaAlloc(croll_VArena *va, size_t size);
+__STATIC_FUNCTION void *croll_varenaAllocAligned(croll_VArena *va, size_t size, size_t align);
+
+/**
+ * @brief Frees everything, committed pages stay committed.
+ *
+ * @param va Pointer to arena.
+ */
+__STATIC_FUNCTION void croll_varenaReset(croll_VArena *va);
+
+/**
+ * @brief Frees everything and decommits pages past keep_bytes.
+ *
+ * Decommitted pages are returned to the OS (MADV_DONTNEED) and made inaccessible again,
+ * the reservation stays.
+ *
+ * @param va         Pointer to arena.
+ * @param keep_bytes Bytes to keep committed.
+ */
+__STATIC_FUNCTION void croll_varenaResetTrim(croll_VArena *va, size_t keep_bytes);
+__STATIC_FUNCTION void croll_varenaResetAdaptive(croll_VArena *va, croll_BumpTrimPolicy *policy);
+
+/**
+ * @brief Releases the reserved range and the arena.
+ *
+ * @param va Pointer to arena.
+ */
+__STATIC_FUNCTION void croll_varenaDestroy(croll_VArena *va);
+#endif // CROLL_HAS_VARENA
+
+/**
+ * @brief Creates a new pool allocator.
+ *
+ * @param pool_size  Number of chunks.
+ * @param chunk_size Size of each chunk (>= sizeof(void*)).
+ * @return           Pointer to allocator or NULL on failure.
+ */
+__STATIC_FUNCTION croll_PoolAlloc *croll_poolNew(size_t pool_size, size_t chunk_size);
+
+/**
+ * @brief Allocates one chunk from the pool, growing it by a block when full.
+ *
+ * @param pool Pointer to pool allocator.
+ * @return     Pointer to chunk or NULL if error.
+ */
+__STATIC_FUNCTION void *croll_poolAlloc(croll_PoolAlloc *pool);
+
+/**
+ * @brief Checks whether ptr is a chunk handed out by the pool.
+ *
+ * O(log blocks): finds the owning block, then checks the pointer is at a chunk
+ * boundary and not past what was carved so far. Double frees are not detected.
+ *
+ * @param pool Pointer to pool allocator.
+ * @param ptr  Pointer to check.
+ * @return     true if ptr is one of the pool's chunks.
+ */
+__STATIC_FUNCTION bool croll_poolOwns(const croll_PoolAlloc *pool, const void *ptr);
 
 /**
  * @brief Frees a chunk back to its pool.
  *
+ * Chunks from any block of the pool go to one free list, reused before new chunks are carved.
+ * With CROLL_POOL_VALIDATE defined or assertions on, a pointer the pool does not own
+ * fails an assert, or is reported and ignored under NDEBUG, instead of corrupting the free list.
+ *
  * @param pool  Pointer to pool allocator.
  * @param chunk Pointer to previously allocated chunk.
  */
@@ -499,338 +1700,3642 @@ __STATIC_FUNCTION void croll_poolFree(croll_PoolAlloc *pool, void *chunk);
 __STATIC_FUNCTION void croll_poolDestroy(croll_PoolAlloc *pool);
 
 //======================================================================
-// Hash Table
+// 2D Grid
 //======================================================================
 /**
- * @brief Creates a new hash table.
+ * @brief Cache-blocked transpose behind croll_gridTranspose.
  *
- * @param key_max_len Maximum key length (for internal pool).
- * @return            Pointer to table or NULL on failure.
+ * Walks both grids in square blocks so reads and writes each stay within
+ * a few cache lines per block, instead of striding a whole column.
+ *
+ * @param dst        Destination data (cols x rows).
+ * @param src        Source data (rows x cols).
+ * @param rows       Source rows.
+ * @param cols       Source columns.
+ * @param src_stride Source row stride in elements.
+ * @param dst_stride Destination row stride in elements.
+ * @param elem_size  Element size in bytes.
  */
-__STATIC_FUNCTION croll_HashTable *croll_htNew(size_t key_max_len);
+__STATIC_FUNCTION void croll__gridTranspose(void *dst, const void *src, size_t rows, size_t cols,
+                                            size_t src_stride, size_t dst_stride, size_t elem_size);
 
+//======================================================================
+// Ring Buffer
+//======================================================================
 /**
- * @brief Inserts or updates an entry in the hash table.
+ * @brief Creates a new single-producer/single-consumer ring buffer.
  *
- * @param ht    Pointer to hash table.
- * @param key   Null-terminated string key.
- * @param value Pointer to value.
- * @return      true on success, false on error.
+ * @param capacity  Minimum number of elements (rounded up to a power of two).
+ * @param elem_size Size of each element in bytes.
+ * @return          Pointer to ring or NULL on failure (including a capacity too big to round up or allocate).
  */
-__STATIC_FUNCTION bool croll_htSet(croll_HashTable *ht, const char *key, void *value);
+__STATIC_FUNCTION croll_Ring *croll_ringNew(size_t capacity, size_t elem_size);
 
 /**
- * @brief Retrieves a value by key.
+ * @brief Pushes one element (producer thread only).
  *
- * @param ht  Pointer to hash table.
- * @param key Null-terminated string key.
- * @return    Pointer to value or NULL if not found.
+ * @param ring Pointer to ring.
+ * @param item Pointer to the element to copy in.
+ * @return     true on success, false if the ring is full.
  */
-__STATIC_FUNCTION void *croll_htGet(croll_HashTable *ht, const char *key);
+__STATIC_FUNCTION bool croll_ringPush(croll_Ring *ring, const void *item);
+
+/**
+ * @brief Pops one element (consumer thread only).
+ *
+ * @param ring Pointer to ring.
+ * @param out  Where the element is copied to.
+ * @return     true on success, false if the ring is empty.
+ */
+__STATIC_FUNCTION bool croll_ringPop(croll_Ring *ring, void *out);
+
+/**
+ * @brief Pushes as many of `count` elements as fit (producer thread only).
+ *
+ * @param ring  Pointer to ring.
+ * @param items Array of elements.
+ * @param count Number of elements in items.
+ * @return      Number of elements pushed.
+ */
+__STATIC_FUNCTION size_t croll_ringPushBatch(croll_Ring *ring, const void *items, size_t count);
+
+/**
+ * @brief Pops up to `max` elements (consumer thread only).
+ *
+ * @param ring Pointer to ring.
+ * @param out  Array with room for max elements.
+ * @param max  Maximum number of elements to pop.
+ * @return     Number of elements popped.
+ */
+__STATIC_FUNCTION size_t croll_ringPopBatch(croll_Ring *ring, void *out, size_t max);
+
+/**
+ * @brief Number of elements in the ring (a snapshot when used concurrently).
+ *
+ * @param ring Pointer to ring.
+ */
+__STATIC_FUNCTION size_t croll_ringLen(croll_Ring *ring);
+
+/**
+ * @brief Destroys a ring and frees its memory.
+ *
+ * @param ring Pointer to ring.
+ */
+__STATIC_FUNCTION void croll_ringDestroy(croll_Ring *ring);
+
+//======================================================================
+// MPMC Queue
+//======================================================================
+/**
+ * @brief Creates a new bounded multi-producer/multi-consumer queue.
+ *
+ * @param capacity  Minimum number of elements (rounded up to a power of two, >= 2).
+ * @param elem_size Size of each element in bytes.
+ * @return          Pointer to queue or NULL on failure (including a capacity too big to round up or allocate).
+ */
+__STATIC_FUNCTION croll_MpmcQueue *croll_mpmcNew(size_t capacity, size_t elem_size);
+
+/**
+ * @brief Pushes one element without blocking.
+ *
+ * @param q    Pointer to queue.
+ * @param item Pointer to the element to copy in.
+ * @return     true on success, false if the queue is full.
+ */
+__STATIC_FUNCTION bool croll_mpmcTryPush(croll_MpmcQueue *q, const void *item);
+
+/**
+ * @brief Pops one element without blocking.
+ *
+ * @param q   Pointer to queue.
+ * @param out Where the element is copied to.
+ * @return    true on success, false if the queue is empty.
+ */
+__STATIC_FUNCTION bool croll_mpmcTryPop(croll_MpmcQueue *q, void *out);
+
+/**
+ * @brief Pushes one element, parking the thread on a futex while the queue is full.
+ *
+ * The futex needs syscall(), under a strict -std=c11 define _DEFAULT_SOURCE (or _GNU_SOURCE)
+ * or parked threads only yield instead of sleeping.
+ *
+ * @param q    Pointer to queue.
+ * @param item Pointer to the element to copy in.
+ */
+__STATIC_FUNCTION void croll_mpmcPush(croll_MpmcQueue *q, const void *item);
+
+/**
+ * @brief Pops one element, parking the thread on a futex while the queue is empty.
+ *
+ * @param q   Pointer to queue.
+ * @param out Where the element is copied to.
+ */
+__STATIC_FUNCTION void croll_mpmcPop(croll_MpmcQueue *q, void *out);
+
+/**
+ * @brief Destroys a queue and frees its memory (no thread may be using it).
+ *
+ * @param q Pointer to queue.
+ */
+__STATIC_FUNCTION void croll_mpmcDestroy(croll_MpmcQueue *q);
+
+//======================================================================
+// Heap
+//======================================================================
+/**
+ * @brief Pushes a value with the given priority.
+ *
+ * `heap->arity` must be 0 (the default, 4) or a power of two >= 2 (2, 4, 8, ...),
+ * children are found with shifts. Any other arity fails an assert.
+ *
+ * @param heap  Pointer to heap.
+ * @param key   Priority, smaller keys are popped first.
+ * @param value Payload (an id not already in the heap when indexed).
+ */
+__STATIC_FUNCTION void croll_heapPush(croll_Heap *heap, croll_u64 key, croll_u64 value);
+
+/**
+ * @brief Returns the node with the smallest key without removing it.
+ *
+ * @param heap Pointer to a non-empty heap.
+ */
+__STATIC_FUNCTION croll_HeapNode croll_heapPeek(const croll_Heap *heap);
+
+/**
+ * @brief Removes and returns the node with the smallest key.
+ *
+ * @param heap Pointer to a non-empty heap.
+ */
+__STATIC_FUNCTION croll_HeapNode croll_heapPop(croll_Heap *heap);
+
+/**
+ * @brief Restores the heap property over `nodes` in O(n).
+ *
+ * Use it after bulk-loading nodes with croll_daExtend(&heap->nodes, ...).
+ *
+ * @param heap Pointer to heap.
+ */
+__STATIC_FUNCTION void croll_heapify(croll_Heap *heap);
+
+/**
+ * @brief Checks whether a value is in an indexed heap.
+ *
+ * @param heap  Pointer to indexed heap.
+ * @param value Value to look up.
+ */
+__STATIC_FUNCTION bool croll_heapContains(const croll_Heap *heap, croll_u64 value);
+
+/**
+ * @brief Lowers the key of a value already in an indexed heap.
+ *
+ * @param heap  Pointer to indexed heap.
+ * @param value Value whose key changes.
+ * @param key   New key.
+ * @return      true on success, false if absent or key is larger than the current one.
+ */
+__STATIC_FUNCTION bool croll_heapDecreaseKey(croll_Heap *heap, croll_u64 value, croll_u64 key);
+
+/**
+ * @brief Frees the heap's storage and leaves it empty (arity is kept).
+ *
+ * @param heap Pointer to heap.
+ */
+__STATIC_FUNCTION void croll_heapFree(croll_Heap *heap);
+
+//======================================================================
+// Bitset
+//======================================================================
+/**
+ * @brief Creates a bitset with all bits cleared.
+ *
+ * @param nbits Number of bits.
+ * @return      The bitset, `words` is NULL on failure.
+ */
+__STATIC_FUNCTION croll_Bitset croll_bitsetNew(size_t nbits);
+
+/**
+ * @brief Sets, clears or tests bit i (i < nbits).
+ */
+__STATIC_FUNCTION void croll_bitsetSet(croll_Bitset *bs, size_t i);
+__STATIC_FUNCTION void croll_bitsetClear(croll_Bitset *bs, size_t i);
+__STATIC_FUNCTION bool croll_bitsetTest(const croll_Bitset *bs, size_t i);
+
+/**
+ * @brief Whole-set operations: dst = a & b, a | b, a ^ b, a & ~b.
+ *
+ * All three sets must have the same size, dst may be a or b.
+ * Uses AVX2 when the running CPU has it.
+ */
+__STATIC_FUNCTION void croll_bitsetAnd(croll_Bitset *dst, const croll_Bitset *a, const croll_Bitset *b);
+__STATIC_FUNCTION void croll_bitsetOr(croll_Bitset *dst, const croll_Bitset *a, const croll_Bitset *b);
+__STATIC_FUNCTION void croll_bitsetXor(croll_Bitset *dst, const croll_Bitset *a, const croll_Bitset *b);
+__STATIC_FUNCTION void croll_bitsetAndNot(croll_Bitset *dst, const croll_Bitset *a, const croll_Bitset *b);
+
+/**
+ * @brief Counts the set bits.
+ *
+ * @param bs Pointer to bitset.
+ * @return   Number of set bits.
+ */
+__STATIC_FUNCTION size_t croll_bitsetCount(const croll_Bitset *bs);
+
+/**
+ * @brief Finds the first set bit at or after `from`.
+ *
+ * @param bs   Pointer to bitset.
+ * @param from First index to look at.
+ * @return     Index of the bit, or nbits if there is none.
+ */
+__STATIC_FUNCTION size_t croll_bitsetNext(const croll_Bitset *bs, size_t from);
+
+/**
+ * @brief Builds (or rebuilds) the rank/select index.
+ *
+ * Costs one u64 per 512 bits. Must be rebuilt after the bits change.
+ *
+ * @param bs Pointer to bitset.
+ * @return   true on success, false on allocation failure.
+ */
+__STATIC_FUNCTION bool croll_bitsetBuildRank(croll_Bitset *bs);
+
+/**
+ * @brief Number of set bits before index i, in O(1) (needs the rank index).
+ *
+ * @param bs Pointer to bitset.
+ * @param i  Index (<= nbits).
+ */
+__STATIC_FUNCTION size_t croll_bitsetRank(const croll_Bitset *bs, size_t i);
+
+/**
+ * @brief Index of the k-th set bit, counting from 0 (needs the rank index).
+ *
+ * @param bs Pointer to bitset.
+ * @param k  Rank of the bit to find.
+ * @return   Index of the bit, or nbits if fewer than k + 1 bits are set.
+ */
+__STATIC_FUNCTION size_t croll_bitsetSelect(const croll_Bitset *bs, size_t k);
+
+/**
+ * @brief Frees a bitset's memory.
+ *
+ * @param bs Pointer to bitset.
+ */
+__STATIC_FUNCTION void croll_bitsetFree(croll_Bitset *bs);
+
+//======================================================================
+// Search Array
+//======================================================================
+/**
+ * @brief Builds a search array from sorted keys.
+ *
+ * @param sorted Keys in ascending order (duplicates allowed), copied.
+ * @param len    Number of keys.
+ * @return       The search array, `keys` is NULL on failure.
+ */
+__STATIC_FUNCTION croll_SearchArray croll_searchNew(const croll_u64 *sorted, size_t len);
+
+/**
+ * @brief Builds a search array from a sorted croll_daDecl(croll_u64, ) array.
+ */
+#define croll_searchFromDa(da) croll_searchNew((da)->data, (da)->len)
+
+/**
+ * @brief Branchless lower/upper bound.
+ *
+ * @param sa  Pointer to search array.
+ * @param key Key to look for.
+ * @return    Sorted index of the first key >= key (lower) or > key (upper), len if none.
+ */
+__STATIC_FUNCTION size_t croll_searchLowerBound(const croll_SearchArray *sa, croll_u64 key);
+__STATIC_FUNCTION size_t croll_searchUpperBound(const croll_SearchArray *sa, croll_u64 key);
+
+/**
+ * @brief Checks whether a key is present.
+ */
+__STATIC_FUNCTION bool croll_searchContains(const croll_SearchArray *sa, croll_u64 key);
+
+/**
+ * @brief Lower bound of many keys at once.
+ *
+ * Runs several searches in lockstep so their cache misses overlap,
+ * worth it once the array no longer fits in cache.
+ *
+ * @param sa    Pointer to search array.
+ * @param keys  Keys to look for.
+ * @param count Number of keys.
+ * @param out   Receives count sorted indices, as croll_searchLowerBound.
+ */
+__STATIC_FUNCTION void croll_searchLowerBoundBatch(const croll_SearchArray *sa, const croll_u64 *keys, size_t count, size_t *out);
+
+/**
+ * @brief Frees a search array's memory.
+ *
+ * @param sa Pointer to search array.
+ */
+__STATIC_FUNCTION void croll_searchFree(croll_SearchArray *sa);
+
+//======================================================================
+// B+tree
+//======================================================================
+/**
+ * @brief Creates an empty B+tree keyed by u64 or by string.
+ *
+ * @return Pointer to tree or NULL on failure.
+ */
+__STATIC_FUNCTION croll_BTree *croll_btreeNew(void);
+__STATIC_FUNCTION croll_BTree *croll_btreeNewStr(void);
+
+/**
+ * @brief Inserts a key or replaces its value.
+ *
+ * String keys are copied.
+ * Use the Str variants on trees made by croll_btreeNewStr only.
+ *
+ * @param tree  Pointer to tree.
+ * @param key   Key.
+ * @param value Value to store.
+ * @return      true on success, false on allocation failure.
+ */
+__STATIC_FUNCTION bool croll_btreeSet(croll_BTree *tree, croll_u64 key, void *value);
+__STATIC_FUNCTION bool croll_btreeSetStr(croll_BTree *tree, croll_StrView key, void *value);
+
+/**
+ * @brief Looks up a key.
+ *
+ * @param tree Pointer to tree.
+ * @param key  Key.
+ * @return     The value, or NULL if the key is absent.
+ */
+__STATIC_FUNCTION void *croll_btreeGet(const croll_BTree *tree, croll_u64 key);
+__STATIC_FUNCTION void *croll_btreeGetStr(const croll_BTree *tree, croll_StrView key);
+
+/**
+ * @brief Fills an empty tree from keys in strictly ascending order.
+ *
+ * Builds full leaves bottom-up, much faster than inserting one by one.
+ *
+ * @param tree   Pointer to an empty tree.
+ * @param keys   Sorted keys.
+ * @param values Values, one per key (may be NULL for all-NULL values).
+ * @param len    Number of keys.
+ * @return       true on success, false on allocation failure.
+ */
+__STATIC_FUNCTION bool croll_btreeBulkLoad(croll_BTree *tree, const croll_u64 *keys, void *const *values, size_t len);
+__STATIC_FUNCTION bool croll_btreeBulkLoadStr(croll_BTree *tree, const croll_StrView *keys, void *const *values, size_t len);
+
+/**
+ * @brief Positions an iterator before the first key, or before the first key >= key.
+ *
+ * Example use:
+ * for(croll_BTreeIter it = croll_btreeSeek(tree, lo); croll_btreeNext(&it) && it.key < hi;)
+ *     use(it.key, it.value);
+ */
+__STATIC_FUNCTION croll_BTreeIter croll_btreeFirst(const croll_BTree *tree);
+__STATIC_FUNCTION croll_BTreeIter croll_btreeSeek(const croll_BTree *tree, croll_u64 key);
+__STATIC_FUNCTION croll_BTreeIter croll_btreeSeekStr(const croll_BTree *tree, croll_StrView key);
+
+/**
+ * @brief Advances an iterator and loads its key and value.
+ *
+ * @param it Pointer to iterator.
+ * @return   false once past the last key.
+ */
+__STATIC_FUNCTION bool croll_btreeNext(croll_BTreeIter *it);
+
+/**
+ * @brief Destroys a tree, its nodes and its copied keys.
+ *
+ * @param tree Pointer to tree.
+ */
+__STATIC_FUNCTION void croll_btreeDestroy(croll_BTree *tree);
+
+//======================================================================
+// Adaptive Radix Tree
+//======================================================================
+/**
+ * @brief Creates an empty adaptive radix tree.
+ *
+ * @return Pointer to tree or NULL on failure.
+ */
+__STATIC_FUNCTION croll_Art *croll_artNew(void);
+
+/**
+ * @brief Inserts a key or replaces its value.
+ *
+ * Keys are arbitrary bytes and may be prefixes of each other.
+ *
+ * @param art   Pointer to tree.
+ * @param key   Key, copied.
+ * @param value Value to store.
+ * @return      true on success, false on allocation failure.
+ */
+__STATIC_FUNCTION bool croll_artSet(croll_Art *art, croll_StrView key, void *value);
+
+/**
+ * @brief Looks up a key.
+ *
+ * @param art Pointer to tree.
+ * @param key Key.
+ * @return    The value, or NULL if the key is absent.
+ */
+__STATIC_FUNCTION void *croll_artGet(const croll_Art *art, croll_StrView key);
+
+/**
+ * @brief Calls fn on every key starting with prefix, in byte order.
+ *
+ * @param art    Pointer to tree.
+ * @param prefix Prefix to match, empty visits every key.
+ * @param fn     Callback, return false to stop early.
+ * @param user   Passed through to fn.
+ * @return       Number of keys visited.
+ */
+__STATIC_FUNCTION size_t croll_artIterPrefix(const croll_Art *art, croll_StrView prefix, croll_ArtVisit fn, void *user);
+
+/**
+ * @brief Counts nodes and bytes per node type.
+ */
+__STATIC_FUNCTION croll_ArtStats croll_artStats(const croll_Art *art);
+
+/**
+ * @brief Destroys a tree, its nodes and its leaves.
+ *
+ * @param art Pointer to tree.
+ */
+__STATIC_FUNCTION void croll_artDestroy(croll_Art *art);
+
+//======================================================================
+// Slot Map
+//======================================================================
+/**
+ * @brief Creates an empty slot map, nothing is allocated until the first insert.
+ *
+ * @param elem_size Size of each object in bytes.
+ * @return          The slot map.
+ */
+__STATIC_FUNCTION croll_SlotMap croll_slotmapNew(size_t elem_size);
+
+/**
+ * @brief Copies an object in, in O(1).
+ *
+ * @param sm   Pointer to slot map.
+ * @param elem Object to copy (elem_size bytes).
+ * @return     Its handle, or CROLL_SLOT_NULL on allocation failure or when out of indices
+ *             (2^32 - 1 slots, 2^20 with CROLL_SLOTMAP_HANDLE32).
+ */
+__STATIC_FUNCTION croll_SlotHandle croll_slotmapInsert(croll_SlotMap *sm, const void *elem);
+
+/**
+ * @brief Resolves a handle.
+ *
+ * The pointer is only good until the next insert or remove.
+ *
+ * @param sm Pointer to slot map.
+ * @param h  Handle.
+ * @return   Pointer to the object, or NULL if the handle is stale or invalid.
+ */
+__STATIC_FUNCTION void *croll_slotmapGet(const croll_SlotMap *sm, croll_SlotHandle h);
+
+/**
+ * @brief Checks whether a handle still refers to a live object.
+ */
+__STATIC_FUNCTION bool croll_slotmapValid(const croll_SlotMap *sm, croll_SlotHandle h);
+
+/**
+ * @brief Removes an object in O(1), the last object moves into its place.
+ *
+ * @param sm Pointer to slot map.
+ * @param h  Handle.
+ * @return   false if the handle was stale or invalid.
+ */
+__STATIC_FUNCTION bool croll_slotmapRemove(croll_SlotMap *sm, croll_SlotHandle h);
+
+/**
+ * @brief Handle of the object at data index i (i < len), for use while iterating.
+ */
+__STATIC_FUNCTION croll_SlotHandle croll_slotmapHandleAt(const croll_SlotMap *sm, size_t i);
+
+/**
+ * @brief Iterates the live objects contiguously.
+ *
+ * Example use:
+ * croll_slotmapForEach(Entity, e, &entities) e->x += e->vx;
+ */
+#define croll_slotmapForEach(type, it, sm) \
+    for(type *it = (type *)(sm)->data; it < (type *)(sm)->data + (sm)->len; it++)
+
+/**
+ * @brief Frees a slot map's memory, all handles become invalid.
+ *
+ * @param sm Pointer to slot map.
+ */
+__STATIC_FUNCTION void croll_slotmapFree(croll_SlotMap *sm);
+
+//======================================================================
+// Packed Array
+//======================================================================
+/**
+ * @brief Creates a packed array of len zeroes at a fixed width.
+ *
+ * @param len  Number of values.
+ * @param bits Bits per value, 1..32.
+ * @return     The array, `words` is NULL on failure.
+ */
+__STATIC_FUNCTION croll_PackedArray croll_packedNew(size_t len, croll_u32 bits);
+
+/**
+ * @brief Appends a value to an array that is not frozen yet.
+ *
+ * @param pa    Pointer to packed array (zero-initialised or appended to before).
+ * @param value Value to append.
+ */
+__STATIC_FUNCTION void croll_packedAppend(croll_PackedArray *pa, croll_u32 value);
+
+/**
+ * @brief Packs the appended values at the narrowest width that holds the largest one.
+ *
+ * @param pa Pointer to packed array.
+ * @return   true on success, false on allocation failure (the staged values are kept).
+ */
+__STATIC_FUNCTION bool croll_packedFreeze(croll_PackedArray *pa);
+
+/**
+ * @brief Reads or writes the value at index i of a frozen array.
+ *
+ * Set keeps only the low `bits` bits of value.
+ */
+__STATIC_FUNCTION croll_u32 croll_packedGet(const croll_PackedArray *pa, size_t i);
+__STATIC_FUNCTION void croll_packedSet(croll_PackedArray *pa, size_t i, croll_u32 value);
+
+/**
+ * @brief Unpacks a range of values into a u32 buffer.
+ *
+ * Decodes 8 values per step with AVX2 when the running CPU has it.
+ *
+ * @param pa    Pointer to packed array.
+ * @param start First index.
+ * @param count Number of values (start + count <= len).
+ * @param out   Receives count values.
+ */
+__STATIC_FUNCTION void croll_packedUnpack(const croll_PackedArray *pa, size_t start, size_t count, croll_u32 *out);
+
+/**
+ * @brief Frees a packed array's memory.
+ *
+ * @param pa Pointer to packed array.
+ */
+__STATIC_FUNCTION void croll_packedFree(croll_PackedArray *pa);
+
+//======================================================================
+// Integer Sequences
+//======================================================================
+/**
+ * @brief Compresses a non-decreasing sequence.
+ *
+ * @param seq    Pointer to a zero-initialised sequence.
+ * @param sorted Values in non-decreasing order.
+ * @param len    Number of values.
+ * @param codec  CROLL_INTSEQ_VARINT, or CROLL_INTSEQ_FOR (each block must span less than 2^32).
+ * @return       false if the input is unsorted or a FOR block spans too much, seq is then left as it was.
+ */
+__STATIC_FUNCTION bool croll_intseqEncode(croll_IntSeq *seq, const croll_u64 *sorted, size_t len, croll_IntSeqCodec codec);
+
+/**
+ * @brief Compresses a sorted croll_daDecl(croll_u64, ) array.
+ */
+#define croll_intseqFromDa(seq, da, codec) croll_intseqEncode((seq), (da)->data, (da)->len, (codec))
+
+/**
+ * @brief Decompresses the whole sequence.
+ *
+ * @param seq Pointer to sequence.
+ * @param out Receives len values.
+ */
+__STATIC_FUNCTION void croll_intseqDecode(const croll_IntSeq *seq, croll_u64 *out);
+
+/**
+ * @brief Starts an iterator before the first value.
+ */
+__STATIC_FUNCTION void croll_intseqIterInit(croll_IntSeqIter *it, const croll_IntSeq *seq);
+
+/**
+ * @brief Moves to the next value.
+ *
+ * @param it Pointer to iterator.
+ * @return   false at the end, otherwise the value is in it->value.
+ */
+__STATIC_FUNCTION bool croll_intseqNext(croll_IntSeqIter *it);
+
+/**
+ * @brief Moves forward to the first value >= target.
+ *
+ * Stays put if the current value is already >= target. Blocks in between are
+ * skipped through the skip table without being decoded.
+ *
+ * @param it     Pointer to iterator.
+ * @param target Value to reach.
+ * @return       false if no such value is left, otherwise it is in it->value.
+ */
+__STATIC_FUNCTION bool croll_intseqSeek(croll_IntSeqIter *it, croll_u64 target);
+
+/**
+ * @brief Intersects two sequences without decompressing them fully.
+ *
+ * @param a   First sequence.
+ * @param b   Second sequence.
+ * @param out Receives the common values, room for min(a->len, b->len).
+ * @return    Number of common values.
+ */
+__STATIC_FUNCTION size_t croll_intseqIntersect(const croll_IntSeq *a, const croll_IntSeq *b, croll_u64 *out);
+
+/**
+ * @brief Frees a sequence's memory.
+ *
+ * @param seq Pointer to sequence.
+ */
+__STATIC_FUNCTION void croll_intseqFree(croll_IntSeq *seq);
+
+//======================================================================
+// Hash Table
+//======================================================================
+/**
+ * @brief Creates a new hash table.
+ *
+ * @param key_max_len Maximum key length (for internal pool).
+ * @return            Pointer to table or NULL on failure.
+ */
+__STATIC_FUNCTION croll_HashTable *croll_htNew(size_t key_max_len);
+
+/**
+ * @brief Inserts or updates an entry in the hash table.
+ *
+ * @param ht    Pointer to hash table.
+ * @param key   Null-terminated string key.
+ * @param value Pointer to value.
+ * @return      true on success, false on error.
+ */
+__STATIC_FUNCTION bool croll_htSet(croll_HashTable *ht, const char *key, void *value);
+
+/**
+ * @brief Retrieves a value by key.
+ *
+ * @param ht  Pointer to hash table.
+ * @param key Null-terminated string key.
+ * @return    Pointer to value or NULL if not found.
+ */
+__STATIC_FUNCTION void *croll_htGet(croll_HashTable *ht, const char *key);
+
+/**
+ * @brief Destroys a hash table and frees all memory.
+ *
+ * @param ht Pointer to hash table.
+ */
+__STATIC_FUNCTION void croll_htDestroy(croll_HashTable *ht);
+
+//======================================================================
+// Miscellaneous
+//======================================================================
+/**
+ * @brief DJB2 string hash function.
+ *
+ * @param str Null-terminated string.
+ * @return    Computed 32/64-bit hash.
+ */
+__STATIC_FUNCTION size_t croll_hashDjb2(const char *str);
+
+#ifdef __cplusplus
+}
+#endif
+
+//======================================================================
+// Implementation
+//======================================================================
+
+#ifdef CROLL_IMPLEMENTATION
+
+// futex-based parking for the blocking queue operations, needs syscall() which glibc hides
+// under a strict -std=c11 / -std=c99 (define _DEFAULT_SOURCE or _GNU_SOURCE there).
+// Without it parked threads fall back to yielding.
+#if defined(__linux__) && (!defined(__STRICT_ANSI__) || defined(_DEFAULT_SOURCE) || defined(_GNU_SOURCE))
+#define CROLL__HAS_FUTEX 1
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <sched.h>
+#endif
+
+#ifdef CROLL_HAS_VARENA
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(MAP_ANONYMOUS)
+    #define CROLL__MAP_ANON MAP_ANONYMOUS
+#else
+    #define CROLL__MAP_ANON MAP_ANON
+#endif
+// Not every system has it, reserving PROT_NONE pages commits nothing there anyway
+#if defined(MAP_NORESERVE)
+    #define CROLL__MAP_NORESERVE MAP_NORESERVE
+#else
+    #define CROLL__MAP_NORESERVE 0
+#endif
+#endif
+
+__STATIC_FUNCTION void croll_init() {
+    croll_STDIN = stdin;
+    croll_STDERR = stderr;
+    croll_STDOUT = stdout;
+}
+
+// logging
+
+__STATIC_FUNCTION void croll_logInfo(const char *format, ...) {
+    fprintf(croll_STDOUT, "\033[94m[INFO]\033[0m ");
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+__STATIC_FUNCTION void croll_logWarn(const char *format, ...) {
+    fprintf(croll_STDERR, "\033[93m[WARN]\033[0m ");
+    va_list args;
+    va_start(args, format);
+    vfprintf(croll_STDERR, format, args);
+    va_end(args);
+}
+
+__STATIC_FUNCTION void croll_logError(const char *format, ...) {
+    fprintf(croll_STDERR, "\033[91m[ERROR]\033[0m ");
+    va_list args;
+    va_start(args, format);
+    vfprintf(croll_STDERR, format, args);
+    va_end(args);
+}
+
+// strings
+
+__STATIC_FUNCTION char *croll_textFmt(const char *format, ...) {
+    #ifndef CROLL_MAX_TEXTFMT_BUFFERS
+    #define CROLL_MAX_TEXTFMT_BUFFERS 4
+    #endif
+
+    #ifndef CROLL_TEXTFMT_BUFFER_SIZE
+    #define CROLL_TEXTFMT_BUFFER_SIZE 1024
+    #endif
+
+    static char buffers[CROLL_MAX_TEXTFMT_BUFFERS][CROLL_TEXTFMT_BUFFER_SIZE] = {0};
+    static int index = 0;
+    index = (index + 1) % CROLL_MAX_TEXTFMT_BUFFERS;
+    
+    memset(buffers[index], 0, CROLL_TEXTFMT_BUFFER_SIZE);
+
+    va_list args;
+    va_start(args, format);
+    int size = vsnprintf(buffers[index], CROLL_TEXTFMT_BUFFER_SIZE, format, args);
+    va_end(args);
+
+    if(size >= CROLL_TEXTFMT_BUFFER_SIZE) {
+        sprintf(buffers[index] + CROLL_TEXTFMT_BUFFER_SIZE - 4, "...");
+    }
+
+    return buffers[index];
+}
+
+__STATIC_FUNCTION char *croll_textSubString(const char *str, size_t start, size_t end) {
+    char *nstr = croll_textFmt("%.*s", (int)((end + 1) - start), str + start);
+    nstr[end + 1] = '\0';
+    return nstr;
+}
+
+// IO
+
+__STATIC_FUNCTION croll_StringBuilder croll_HgetLine() {
+    croll_StringBuilder sb = {0};
+    while (true) {
+        char c = fgetc(croll_STDIN);
+        if (c == EOF || c == '\n') break;
+        croll_daAppend(&sb, c);
+    }
+    croll_daAppend(&sb, '\0'); // ensures null termination
+    return sb;
+}
+
+__STATIC_FUNCTION bool croll_SgetLine(char *buffer, size_t buffer_size) {
+    croll_ASSERT(buffer != NULL, "Buffer must not be NULL at file: "__FILE__);
+    croll_ASSERT(buffer_size > 0, "Buffer size must be greater than 0 at file: "__FILE__);
+    size_t buffer_length = 1;
+    while (true) {
+        char c = fgetc(croll_STDIN);
+        if (c == EOF || c == '\n') break;
+        *buffer++ = c;
+        buffer_length++;
+        if (buffer_length >= buffer_size) {
+            *buffer = '\0';
+            return false;
+        }
+    }
+    *buffer = '\0';
+    return true;
+}
+
+__STATIC_FUNCTION croll_StringBuilder croll_readEntireFile(const char *path) {
+    FILE *file = fopen(path, "r");
+    croll_checkNullPtr(file) return (croll_StringBuilder){0};
+    croll_StringBuilder sb = {0};
+
+    while (true) {
+        char c = fgetc(file);
+        if (c == EOF) break;
+        croll_sbAppend(&sb, c);
+    }
+    croll_sbAppend(&sb, '\0'); // ensures null termination
+    fclose(file);
+    return sb;
+}
+
+// dynamic array reductions
+
+#define CROLL__SIMD_NONE 0
+#define CROLL__SIMD_SSE  1
+#define CROLL__SIMD_AVX2 2
+
+// Detected once, later calls only read the cached level.
+// Threads racing on the first call all compute the same value, the atomic only keeps that race defined.
+__STATIC_FUNCTION int croll__simdLevel(void) {
+#ifdef CROLL__X86_SIMD
+    static _Atomic int level = -1;
+    int l = atomic_load_explicit(&level, memory_order_relaxed);
+    if(l < 0) {
+        __builtin_cpu_init();
+        l = CROLL__SIMD_NONE;
+        if(__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) l = CROLL__SIMD_SSE;
+        if(l == CROLL__SIMD_SSE && __builtin_cpu_supports("avx2")) l = CROLL__SIMD_AVX2;
+        atomic_store_explicit(&level, l, memory_order_relaxed);
+    }
+    return l;
+#else
+    return CROLL__SIMD_NONE;
+#endif
+}
+
+#ifdef CROLL__X86_SIMD
+#define CROLL__SIMD_DISPATCH(kernel, ...)                        \
+    switch(croll__simdLevel()) {                                 \
+        case CROLL__SIMD_AVX2: return kernel##Avx2(__VA_ARGS__); \
+        case CROLL__SIMD_SSE:  return kernel##Sse(__VA_ARGS__);  \
+        default:               return kernel##Scalar(__VA_ARGS__); \
+    }
+// Same for kernels returning void, C doesn't allow `return` with a void expression
+#define CROLL__SIMD_DISPATCH_VOID(kernel, ...)                        \
+    switch(croll__simdLevel()) {                                      \
+        case CROLL__SIMD_AVX2: kernel##Avx2(__VA_ARGS__); return;     \
+        case CROLL__SIMD_SSE:  kernel##Sse(__VA_ARGS__); return;      \
+        default:               kernel##Scalar(__VA_ARGS__); return;   \
+    }
+#else
+#define CROLL__SIMD_DISPATCH(kernel, ...) return kernel##Scalar(__VA_ARGS__)
+#define CROLL__SIMD_DISPATCH_VOID(kernel, ...) kernel##Scalar(__VA_ARGS__)
+#endif
+
+#define CROLL__RED_MIN(a, b) ((b) < (a) ? (b) : (a))
+#define CROLL__RED_MAX(a, b) ((b) > (a) ? (b) : (a))
+#define CROLL__RED_ADD(a, b) ((a) + (b))
+
+// Four independent accumulators, so the loop isn't bound by the latency of a single dependency chain
+#define CROLL__REDUCE_SCALAR(fn, T, R, RED)                                  \
+    __STATIC_FUNCTION R fn(const T *data, size_t len, R init) {              \
+        R a0 = init, a1 = init, a2 = init, a3 = init;                        \
+        size_t i = 0;                                                        \
+        for(; i + 4 <= len; i += 4) {                                        \
+            a0 = RED(a0, (R)data[i]);                                        \
+            a1 = RED(a1, (R)data[i + 1]);                                    \
+            a2 = RED(a2, (R)data[i + 2]);                                    \
+            a3 = RED(a3, (R)data[i + 3]);                                    \
+        }                                                                    \
+        for(; i < len; i++) a0 = RED(a0, (R)data[i]);                        \
+        a0 = RED(a0, a1);                                                    \
+        a2 = RED(a2, a3);                                                    \
+        return RED(a0, a2);                                                  \
+    }
+
+#define CROLL__COUNT_SCALAR(fn, T)                                           \
+    __STATIC_FUNCTION size_t fn(const T *data, size_t len, T value) {        \
+        size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0, i = 0;                        \
+        for(; i + 4 <= len; i += 4) {                                        \
+            c0 += data[i] == value;                                          \
+            c1 += data[i + 1] == value;                                      \
+            c2 += data[i + 2] == value;                                      \
+            c3 += data[i + 3] == value;                                      \
+        }                                                                    \
+        for(; i < len; i++) c0 += data[i] == value;                          \
+        return c0 + c1 + c2 + c3;                                            \
+    }
+
+#ifdef CROLL__X86_SIMD
+// LANES is the number of source elements consumed per vector, L the type of a vector lane
+#define CROLL__REDUCE_SIMD(fn, tgt, T, R, L, VT, LANES, LOAD, SET1, OP, STORE, RED)     \
+    static __attribute__((target(tgt))) R fn(const T *data, size_t len, R init) {       \
+        VT a0 = SET1(init), a1 = a0, a2 = a0, a3 = a0;                                   \
+        size_t i = 0;                                                                   \
+        /* New data goes first: float min/max return the second operand on NaN */     \
+        for(; i + 4 * (LANES) <= len; i += 4 * (LANES)) {                               \
+            a0 = OP(LOAD(data + i), a0);                                                \
+            a1 = OP(LOAD(data + i + (LANES)), a1);                                      \
+            a2 = OP(LOAD(data + i + 2 * (LANES)), a2);                                  \
+            a3 = OP(LOAD(data + i + 3 * (LANES)), a3);                                  \
+        }                                                                               \
+        a0 = OP(OP(a0, a1), OP(a2, a3));                                                \
+        L lanes[LANES];                                                                 \
+        STORE(lanes, a0);                                                               \
+        R r = init;                                                                     \
+        for(size_t j = 0; j < (LANES); j++) r = RED(r, (R)lanes[j]);                    \
+        for(; i < len; i++) r = RED(r, (R)data[i]);                                     \
+        return r;                                                                       \
+    }
+
+// EQMASK yields one bit per matching lane, counted with popcnt
+#define CROLL__COUNT_SIMD(fn, tgt, T, VT, LANES, LOAD, SET1, EQMASK)                    \
+    static __attribute__((target(tgt))) size_t fn(const T *data, size_t len, T value) { \
+        VT v = SET1(value);                                                             \
+        size_t c0 = 0, c1 = 0, i = 0;                                                   \
+        for(; i + 2 * (LANES) <= len; i += 2 * (LANES)) {                               \
+            c0 += (size_t)__builtin_popcount((unsigned)EQMASK(LOAD(data + i), v));      \
+            c1 += (size_t)__builtin_popcount((unsigned)EQMASK(LOAD(data + i + (LANES)), v)); \
+        }                                                                               \
+        for(; i < len; i++) c0 += data[i] == value;                                     \
+        return c0 + c1;                                                                 \
+    }
+
+#define CROLL__AVX2 static inline __attribute__((target("avx2")))
+#define CROLL__SSE static inline __attribute__((target("sse4.2")))
+
+CROLL__AVX2 __m256i croll__ld256(const void *p) { return _mm256_loadu_si256((const __m256i *)p); }
+CROLL__AVX2 __m256 croll__ld256Ps(const void *p) { return _mm256_loadu_ps((const float *)p); }
+CROLL__AVX2 __m256d croll__ld256Pd(const void *p) { return _mm256_loadu_pd((const double *)p); }
+CROLL__AVX2 __m256i croll__ld256WidenI32(const void *p) { return _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)p)); }
+CROLL__AVX2 __m256i croll__ld256WidenU32(const void *p) { return _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *)p)); }
+CROLL__AVX2 void croll__st256(void *p, __m256i v) { _mm256_storeu_si256((__m256i *)p, v); }
+CROLL__AVX2 void croll__st256Ps(void *p, __m256 v) { _mm256_storeu_ps((float *)p, v); }
+CROLL__AVX2 void croll__st256Pd(void *p, __m256d v) { _mm256_storeu_pd((double *)p, v); }
+CROLL__AVX2 __m256i croll__gt256U64(__m256i a, __m256i b) {
+    __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    return _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+}
+CROLL__AVX2 __m256i croll__min256I64(__m256i a, __m256i b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+CROLL__AVX2 __m256i croll__max256I64(__m256i a, __m256i b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+CROLL__AVX2 __m256i croll__min256U64(__m256i a, __m256i b) { return _mm256_blendv_epi8(a, b, croll__gt256U64(a, b)); }
+CROLL__AVX2 __m256i croll__max256U64(__m256i a, __m256i b) { return _mm256_blendv_epi8(b, a, croll__gt256U64(a, b)); }
+CROLL__AVX2 int croll__eq256I32(__m256i a, __m256i b) { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))); }
+CROLL__AVX2 int croll__eq256I64(__m256i a, __m256i b) { return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b))); }
+CROLL__AVX2 int croll__eq256Ps(__m256 a, __m256 b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+CROLL__AVX2 int croll__eq256Pd(__m256d a, __m256d b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+
+CROLL__SSE __m128i croll__ld128(const void *p) { return _mm_loadu_si128((const __m128i *)p); }
+CROLL__SSE __m128 croll__ld128Ps(const void *p) { return _mm_loadu_ps((const float *)p); }
+CROLL__SSE __m128d croll__ld128Pd(const void *p) { return _mm_loadu_pd((const double *)p); }
+CROLL__SSE __m128i croll__ld128WidenI32(const void *p) { return _mm_cvtepi32_epi64(_mm_loadl_epi64((const __m128i *)p)); }
+CROLL__SSE __m128i croll__ld128WidenU32(const void *p) { return _mm_cvtepu32_epi64(_mm_loadl_epi64((const __m128i *)p)); }
+CROLL__SSE void croll__st128(void *p, __m128i v) { _mm_storeu_si128((__m128i *)p, v); }
+CROLL__SSE void croll__st128Ps(void *p, __m128 v) { _mm_storeu_ps((float *)p, v); }
+CROLL__SSE void croll__st128Pd(void *p, __m128d v) { _mm_storeu_pd((double *)p, v); }
+CROLL__SSE __m128i croll__gt128U64(__m128i a, __m128i b) {
+    __m128i sign = _mm_set1_epi64x(INT64_MIN);
+    return _mm_cmpgt_epi64(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign));
+}
+CROLL__SSE __m128i croll__min128I64(__m128i a, __m128i b) { return _mm_blendv_epi8(a, b, _mm_cmpgt_epi64(a, b)); }
+CROLL__SSE __m128i croll__max128I64(__m128i a, __m128i b) { return _mm_blendv_epi8(b, a, _mm_cmpgt_epi64(a, b)); }
+CROLL__SSE __m128i croll__min128U64(__m128i a, __m128i b) { return _mm_blendv_epi8(a, b, croll__gt128U64(a, b)); }
+CROLL__SSE __m128i croll__max128U64(__m128i a, __m128i b) { return _mm_blendv_epi8(b, a, croll__gt128U64(a, b)); }
+CROLL__SSE int croll__eq128I32(__m128i a, __m128i b) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+CROLL__SSE int croll__eq128I64(__m128i a, __m128i b) { return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(a, b))); }
+CROLL__SSE int croll__eq128Ps(__m128 a, __m128 b) { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+CROLL__SSE int croll__eq128Pd(__m128d a, __m128d b) { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+
+// croll_i32
+CROLL__REDUCE_SIMD(croll__minI32Avx2, "avx2", croll_i32, croll_i32, croll_i32, __m256i, 8, croll__ld256, _mm256_set1_epi32, _mm256_min_epi32, croll__st256, CROLL__RED_MIN)
+CROLL__REDUCE_SIMD(croll__maxI32Avx2, "avx2", croll_i32, croll_i32, croll_i32, __m256i, 8, croll__ld256, _mm256_set1_epi32, _mm256_max_epi32, croll__st256, CROLL__RED_MAX)
+CROLL__REDUCE_SIMD(croll__sumI32Avx2, "avx2", croll_i32, croll_i64, croll_i64, __m256i, 4, croll__ld256WidenI32, _mm256_set1_epi64x, _mm256_add_epi64, croll__st256, CROLL__RED_ADD)
+CROLL__COUNT_SIMD(croll__countI32Avx2, "avx2,popcnt", croll_i32, __m256i, 8, croll__ld256, _mm256_set1_epi32, croll__eq256I32)
+CROLL__REDUCE_SIMD(croll__minI32Sse, "sse4.2", croll_i32, croll_i32, croll_i32, __m128i, 4, croll__ld128, _mm_set1_epi32, _mm_min_epi32, croll__st128, CROLL__RED_MIN)
+CROLL__REDUCE_SIMD(croll__maxI32Sse, "sse4.2", croll_i32, croll_i32, croll_i32, __m128i, 4, croll__ld128, _mm_set1_epi32, _mm_max_epi32, croll__st128, CROLL__RED_MAX)
+CROLL__REDUCE_SIMD(croll__sumI32Sse, "sse4.2", croll_i32, croll_i64, croll_i64, __m128i, 2, croll__ld128WidenI32, _mm_set1_epi64x, _mm_add_epi64, croll__st128, CROLL__RED_ADD)
+CROLL__COUNT_SIMD(croll__countI32Sse, "sse4.2,popcnt", croll_i32, __m128i, 4, croll__ld128, _mm_set1_epi32, croll__eq128I32)
+
+// croll_u32
+CROLL__REDUCE_SIMD(croll__minU32Avx2, "avx2", croll_u32, croll_u32, croll_u32, __m256i, 8, croll__ld256, _mm256_set1_epi32, _mm256_min_epu32, croll__st256, CROLL__RED_MIN)
+CROLL__REDUCE_SIMD(croll__maxU32Avx2, "avx2", croll_u32, croll_u32, croll_u32, __m256i, 8, croll__ld256, _mm256_set1_epi32, _mm256_max_epu32, croll__st256, CROLL__RED_MAX)
+CROLL__REDUCE_SIMD(croll__sumU32Avx2, "avx2", croll_u32, croll_u64, croll_u64, __m256i, 4, croll__ld256WidenU32, _mm256_set1_epi64x, _mm256_add_epi64, croll__st256, CROLL__RED_ADD)
+CROLL__COUNT_SIMD(croll__countU32Avx2, "avx2,popcnt", croll_u32, __m256i, 8, croll__ld256, _mm256_set1_epi32, croll__eq256I32)
+CROLL__REDUCE_SIMD(croll__minU32Sse, "sse4.2", croll_u32, croll_u32, croll_u32, __m128i, 4, croll__ld128, _mm_set1_epi32, _mm_min_epu32, croll__st128, CROLL__RED_MIN)
+CROLL__REDUCE_SIMD(croll__maxU32Sse, "sse4.2", croll_u32, croll_u32, croll_u32, __m128i, 4, croll__ld128, _mm_set1_epi32, _mm_max_epu32, croll__st128, CROLL__RED_MAX)
+CROLL__REDUCE_SIMD(croll__sumU32Sse, "sse4.2", croll_u32, croll_u64, croll_u64, __m128i, 2, croll__ld128WidenU32, _mm_set1_epi64x, _mm_add_epi64, croll__st128, CROLL__RED_ADD)
+CROLL__COUNT_SIMD(croll__countU32Sse, "sse4.2,popcnt", croll_u32, __m128i, 4, croll__ld128, _mm_set1_epi32, croll__eq128I32)
+
+// croll_i64
+CROLL__REDUCE_SIMD(croll__minI64Avx2, "avx2", croll_i64, croll_i64, croll_i64, __m256i, 4, croll__ld256, _mm256_set1_epi64x, croll__min256I64, croll__st256, CROLL__RED_MIN)
+CROLL__REDUCE_SIMD(croll__maxI64Avx2, "avx2", croll_i64, croll_i64, croll_i64, __m256i, 4, croll__ld256, _mm256_set1_epi64x, croll__max256I64, croll__st256, CROLL__RED_MAX)
+CROLL__REDUCE_SIMD(croll__sumI64Avx2, "avx2", croll_i64, croll_i64, croll_i64, __m256i, 4, croll__ld256, _mm256_set1_epi64x, _mm256_add_epi64, croll__st256, CROLL__RED_ADD)
+CROLL__COUNT_SIMD(croll__countI64Avx2, "avx2,popcnt", croll_i64, __m256i, 4, croll__ld256, _mm256_set1_epi64x, croll__eq256I64)
+CROLL__REDUCE_SIMD(croll__minI64Sse, "sse4.2", croll_i64, croll_i64, croll_i64, __m128i, 2, croll__ld128, _mm_set1_epi64x, croll__min128I64, croll__st128, CROLL__RED_MIN)
+CROLL__REDUCE_SIMD(croll__maxI64Sse, "sse4.2", croll_i64, croll_i64, croll_i64, __m128i, 2, croll__ld128, _mm_set1_epi64x, croll__max128I64, croll__st128, CROLL__RED_MAX)
+CROLL__REDUCE_SIMD(croll__sumI64Sse, "sse4.2", croll_i64, croll_i64, croll_i64, __m128i, 2, croll__ld128, _mm_set1_epi64x, _mm_add_epi64, croll__st128, CROLL__RED_ADD)
+CROLL__COUNT_SIMD(croll__countI64Sse, "sse4.2,popcnt", croll_i64, __m128i, 2, croll__ld128, _mm_set1_epi64x, croll__eq128I64)
+
+// croll_u64
+CROLL__REDUCE_SIMD(croll__minU64Avx2, "avx2", croll_u64, croll_u64, croll_u64, __m256i, 4, croll__ld256, _mm256_set1_epi64x, croll__min256U64, croll__st256, CROLL__RED_MIN)
+CROLL__REDUCE_SIMD(croll__maxU64Avx2, "avx2", croll_u64, croll_u64, croll_u64, __m256i, 4, croll__ld256, _mm256_set1_epi64x, croll__max256U64, croll__st256, CROLL__RED_MAX)
+CROLL__REDUCE_SIMD(croll__sumU64Avx2, "avx2", croll_u64, croll_u64, croll_u64, __m256i, 4, croll__ld256, _mm256_set1_epi64x, _mm256_add_epi64, croll__st256, CROLL__RED_ADD)
+CROLL__COUNT_SIMD(croll__countU64Avx2, "avx2,popcnt", croll_u64, __m256i, 4, croll__ld256, _mm256_set1_epi64x, croll__eq256I64)
+CROLL__REDUCE_SIMD(croll__minU64Sse, "sse4.2", croll_u64, croll_u64, croll_u64, __m128i, 2, croll__ld128, _mm_set1_epi64x, croll__min128U64, croll__st128, CROLL__RED_MIN)
+CROLL__REDUCE_SIMD(croll__maxU64Sse, "sse4.2", croll_u64, croll_u64, croll_u64, __m128i, 2, croll__ld128, _mm_set1_epi64x, croll__max128U64, croll__st128, CROLL__RED_MAX)
+CROLL__REDUCE_SIMD(croll__sumU64Sse, "sse4.2", croll_u64, croll_u64, croll_u64, __m128i, 2, croll__ld128, _mm_set1_epi64x, _mm_add_epi64, croll__st128, CROLL__RED_ADD)
+CROLL__COUNT_SIMD(croll__countU64Sse, "sse4.2,popcnt", croll_u64, __m128i, 2, croll__ld128, _mm_set1_epi64x, croll__eq128I64)
+
+// croll_f32
+CROLL__REDUCE_SIMD(croll__minF32Avx2, "avx2", croll_f32, croll_f32, croll_f32, __m256, 8, croll__ld256Ps, _mm256_set1_ps, _mm256_min_ps, croll__st256Ps, CROLL__RED_MIN)
+CROLL__REDUCE_SIMD(croll__maxF32Avx2, "avx2", croll_f32, croll_f32, croll_f32, __m256, 8, croll__ld256Ps, _mm256_set1_ps, _mm256_max_ps, croll__st256Ps, CROLL__RED_MAX)
+CROLL__REDUCE_SIMD(croll__sumF32Avx2, "avx2", croll_f32, croll_f32, croll_f32, __m256, 8, croll__ld256Ps, _mm256_set1_ps, _mm256_add_ps, croll__st256Ps, CROLL__RED_ADD)
+CROLL__COUNT_SIMD(croll__countF32Avx2, "avx2,popcnt", croll_f32, __m256, 8, croll__ld256Ps, _mm256_set1_ps, croll__eq256Ps)
+CROLL__REDUCE_SIMD(croll__minF32Sse, "sse4.2", croll_f32, croll_f32, croll_f32, __m128, 4, croll__ld128Ps, _mm_set1_ps, _mm_min_ps, croll__st128Ps, CROLL__RED_MIN)
+CROLL__REDUCE_SIMD(croll__maxF32Sse, "sse4.2", croll_f32, croll_f32, croll_f32, __m128, 4, croll__ld128Ps, _mm_set1_ps, _mm_max_ps, croll__st128Ps, CROLL__RED_MAX)
+CROLL__REDUCE_SIMD(croll__sumF32Sse, "sse4.2", croll_f32, croll_f32, croll_f32, __m128, 4, croll__ld128Ps, _mm_set1_ps, _mm_add_ps, croll__st128Ps, CROLL__RED_ADD)
+CROLL__COUNT_SIMD(croll__countF32Sse, "sse4.2,popcnt", croll_f32, __m128, 4, croll__ld128Ps, _mm_set1_ps, croll__eq128Ps)
+
+// croll_f64
+CROLL__REDUCE_SIMD(croll__minF64Avx2, "avx2", croll_f64, croll_f64, croll_f64, __m256d, 4, croll__ld256Pd, _mm256_set1_pd, _mm256_min_pd, croll__st256Pd, CROLL__RED_MIN)
+CROLL__REDUCE_SIMD(croll__maxF64Avx2, "avx2", croll_f64, croll_f64, croll_f64, __m256d, 4, croll__ld256Pd, _mm256_set1_pd, _mm256_max_pd, croll__st256Pd, CROLL__RED_MAX)
+CROLL__REDUCE_SIMD(croll__sumF64Avx2, "avx2", croll_f64, croll_f64, croll_f64, __m256d, 4, croll__ld256Pd, _mm256_set1_pd, _mm256_add_pd, croll__st256Pd, CROLL__RED_ADD)
+CROLL__COUNT_SIMD(croll__countF64Avx2, "avx2,popcnt", croll_f64, __m256d, 4, croll__ld256Pd, _mm256_set1_pd, croll__eq256Pd)
+CROLL__REDUCE_SIMD(croll__minF64Sse, "sse4.2", croll_f64, croll_f64, croll_f64, __m128d, 2, croll__ld128Pd, _mm_set1_pd, _mm_min_pd, croll__st128Pd, CROLL__RED_MIN)
+CROLL__REDUCE_SIMD(croll__maxF64Sse, "sse4.2", croll_f64, croll_f64, croll_f64, __m128d, 2, croll__ld128Pd, _mm_set1_pd, _mm_max_pd, croll__st128Pd, CROLL__RED_MAX)
+CROLL__REDUCE_SIMD(croll__sumF64Sse, "sse4.2", croll_f64, croll_f64, croll_f64, __m128d, 2, croll__ld128Pd, _mm_set1_pd, _mm_add_pd, croll__st128Pd, CROLL__RED_ADD)
+CROLL__COUNT_SIMD(croll__countF64Sse, "sse4.2,popcnt", croll_f64, __m128d, 2, croll__ld128Pd, _mm_set1_pd, croll__eq128Pd)
+#endif // CROLL__X86_SIMD
+
+// First element that isn't NaN (always data[0] for integers), min/max start from it
+// so NaN never gets into an accumulator. NaN only if every element is.
+#define CROLL__REDUCE_SEED(T, data, len)                                                            \
+    T seed = (data)[0];                                                                             \
+    for(size_t k = 1; seed != seed && k < (len); k++) seed = (data)[k];                             \
+    if(seed != seed) return seed;
+
+// Public entry points, one set per element type
+#define CROLL__DA_REDUCE_IMPL(sfx, T, S)                                                            \
+    CROLL__REDUCE_SCALAR(croll__min##sfx##Scalar, T, T, CROLL__RED_MIN)                             \
+    CROLL__REDUCE_SCALAR(croll__max##sfx##Scalar, T, T, CROLL__RED_MAX)                             \
+    CROLL__REDUCE_SCALAR(croll__sum##sfx##Scalar, T, S, CROLL__RED_ADD)                             \
+    CROLL__COUNT_SCALAR(croll__count##sfx##Scalar, T)                                               \
+                                                                                                    \
+    __STATIC_FUNCTION T croll_daMin##sfx(const T *data, size_t len) {                               \
+        croll_ASSERT(len > 0, "Cannot reduce an empty array at file: "__FILE__);                   \
+        CROLL__REDUCE_SEED(T, data, len)                                                            \
+        CROLL__SIMD_DISPATCH(croll__min##sfx, data, len, seed);                                     \
+    }                                                                                               \
+    __STATIC_FUNCTION T croll_daMax##sfx(const T *data, size_t len) {                               \
+        croll_ASSERT(len > 0, "Cannot reduce an empty array at file: "__FILE__);                   \
+        CROLL__REDUCE_SEED(T, data, len)                                                            \
+        CROLL__SIMD_DISPATCH(croll__max##sfx, data, len, seed);                                     \
+    }                                                                                               \
+    __STATIC_FUNCTION S croll_daSum##sfx(const T *data, size_t len) {                               \
+        CROLL__SIMD_DISPATCH(croll__sum##sfx, data, len, (S)0);                                     \
+    }                                                                                               \
+    __STATIC_FUNCTION size_t croll_daCount##sfx(const T *data, size_t len, T value) {               \
+        CROLL__SIMD_DISPATCH(croll__count##sfx, data, len, value);                                  \
+    }                                                                                               \
+    /* Vectorized max, then a blocked scan that stops at the first block holding it */              \
+    __STATIC_FUNCTION size_t croll_daArgMax##sfx(const T *data, size_t len) {                       \
+        T max = croll_daMax##sfx(data, len);                                                        \
+        size_t i = 0;                                                                               \
+        for(; i + 16 <= len; i += 16) {                                                             \
+            bool hit = false;                                                                       \
+            for(size_t j = 0; j < 16; j++) hit |= data[i + j] == max;                               \
+            if(hit) break;                                                                          \
+        }                                                                                           \
+        for(; i < len; i++)                                                                         \
+            if(data[i] == max) return i;                                                            \
+        return 0; /* only reachable when max is NaN */                                              \
+    }
+
+CROLL__DA_REDUCE_IMPL(I32, croll_i32, croll_i64)
+CROLL__DA_REDUCE_IMPL(U32, croll_u32, croll_u64)
+CROLL__DA_REDUCE_IMPL(I64, croll_i64, croll_i64)
+CROLL__DA_REDUCE_IMPL(U64, croll_u64, croll_u64)
+CROLL__DA_REDUCE_IMPL(F32, croll_f32, croll_f32)
+CROLL__DA_REDUCE_IMPL(F64, croll_f64, croll_f64)
+
+// memory
+
+__STATIC_FUNCTION croll_BumpAlloc *croll_bumpNewAligned(size_t cap, size_t block_align) {
+    croll_ASSERT((block_align & (block_align - 1)) == 0 && block_align <= CROLL_BUMP_MAX_ALIGN,
+                 "Bump block alignment must be a power of two up to CROLL_BUMP_MAX_ALIGN at file: "__FILE__);
+    croll_BumpAlloc *bump = malloc(sizeof(croll_BumpAlloc));
+    croll_checkNullPtr(bump) return NULL;
+    
+    if(block_align > 1) {
+        // aligned_alloc wants a multiple of the alignment
+        cap = (cap + block_align - 1) & ~(block_align - 1);
+        bump->data = aligned_alloc(block_align, cap ? cap : block_align);
+    } else {
+        bump->data = malloc(cap);
+    }
+    croll_checkNullPtr(bump->data) {
+        free(bump);
+        return NULL;
+    }
+    bump->_next = NULL;
+    bump->_current = bump;
+    bump->_side = NULL;
+    bump->size = cap;
+    bump->offset = 0;
+    bump->_block_align = block_align > 1 ? block_align : 0;
+#ifdef CROLL_BUMP_STATS
+    memset(&bump->_stats, 0, sizeof(bump->_stats));
+    bump->_live = 0;
+#endif
+    
+    return bump;
+}
+
+__STATIC_FUNCTION croll_BumpAlloc *croll_bumpNew(size_t cap) {
+    return croll_bumpNewAligned(cap, 0);
+}
+
+#ifdef CROLL_BUMP_STATS
+static void croll__bumpRecord(croll_BumpAlloc *head, size_t requested, size_t consumed) {
+    croll_BumpStats *stats = &head->_stats;
+    size_t bucket = croll__log2(requested);
+    stats->histogram[bucket < CROLL_BUMP_STATS_BUCKETS ? bucket : CROLL_BUMP_STATS_BUCKETS - 1]++;
+    stats->allocations++;
+    stats->requested += requested;
+    stats->consumed += consumed;
+    head->_live += consumed;
+    if(head->_live > stats->peak) stats->peak = head->_live;
+}
+    #define CROLL__BUMP_RECORD(head, requested, consumed) croll__bumpRecord(head, requested, consumed)
+#else
+    #define CROLL__BUMP_RECORD(head, requested, consumed) ((void)(head), (void)(requested), (void)(consumed))
+#endif
+
+// Frees block and every block chained after it
+static void croll__bumpFreeChain(croll_BumpAlloc *block) {
+    while(block != NULL) {
+        croll_BumpAlloc *next = block->_next;
+        free(block->data);
+        free(block);
+        block = next;
+    }
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR void *croll_bumpAlloc(croll_BumpAlloc *bump, size_t size) {
+    if(size == 0) return NULL;
+    size_t requested = size;
+    if(size & 0b111) size = croll_ALLOC_ALIGN(size);
+
+    croll_BumpAlloc *block = bump->_current;
+    size_t cur_addr = (size_t)block->data + block->offset;
+    if(cur_addr + size > (size_t)block->data + block->size)
+        return NULL;
+    
+    block->offset += size;
+    CROLL__BUMP_RECORD(bump, requested, size);
+    return (void *)cur_addr;
+}
+
+// Moves the head's current block to one with room for size bytes, chaining a bigger block if needed.
+// Requests over CROLL_BUMP_MAX_BLOCK_SIZE get a side block instead, the current block stays as is.
+static croll_BumpAlloc *croll__bumpExpand(croll_BumpAlloc *head, size_t size) {
+    croll_BumpAlloc *block = head->_current;
+    // Blocks left over from before a reset are reused while they are big enough
+    while(block->_next != NULL) {
+        block = block->_next;
+        if(block->size - block->offset >= size) {
+            head->_current = block;
+            return block;
+        }
+    }
+
+    if(size > CROLL_BUMP_MAX_BLOCK_SIZE) {
+        croll_BumpAlloc *side = croll_bumpNewAligned(size, head->_block_align);
+        croll_checkNullPtr(side) return NULL;
+        side->_next = head->_side;
+        head->_side = side;
+        return side;
+    }
+
+    // The chain only holds regular blocks, so growth follows the last one
+    size_t grown = block->size * 2;
+    if(grown > CROLL_BUMP_MAX_BLOCK_SIZE) grown = CROLL_BUMP_MAX_BLOCK_SIZE;
+    if(grown < size) grown = size;
+
+    block->_next = croll_bumpNewAligned(grown, head->_block_align);
+    croll_checkNullPtr(block->_next) return NULL;
+    head->_current = block->_next;
+    return block->_next;
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR void *croll_bumpAllocOrExpand(croll_BumpAlloc *bump, size_t size) {
+    if(size == 0) return NULL;
+    size_t requested = size;
+    if(size & 0b111) size = croll_ALLOC_ALIGN(size);
+
+    croll_BumpAlloc *block = bump->_current;
+    if(block->size - block->offset < size) {
+        block = croll__bumpExpand(bump, size);
+        croll_checkNullPtr(block) return NULL;
+    }
+
+    void *ptr = block->data + block->offset;
+    block->offset += size;
+    CROLL__BUMP_RECORD(bump, requested, size);
+    return ptr;
+} 
+
+// Aligned allocation from a given block of the arena, the current one or a fresh side block
+static __CROLL_INLINE_ATTR void *croll__bumpAllocAlignedIn(croll_BumpAlloc *bump, croll_BumpAlloc *block, size_t size, size_t align) {
+    if(size == 0) return NULL;
+    size_t requested = size;
+    if(size & 0b111) size = croll_ALLOC_ALIGN(size);
+
+    size_t base = (size_t)block->data + block->offset;
+    size_t pad = ((base + align - 1) & ~(align - 1)) - base;
+    if(pad + size > block->size - block->offset) return NULL;
+
+    block->offset += pad + size;
+    CROLL__BUMP_RECORD(bump, requested, pad + size);
+    return (void *)(base + pad);
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR void *croll_bumpAllocAligned(croll_BumpAlloc *bump, size_t size, size_t align) {
+    croll_ASSERT(align && (align & (align - 1)) == 0 && align <= CROLL_BUMP_MAX_ALIGN,
+                 "Bump alignment must be a power of two up to CROLL_BUMP_MAX_ALIGN at file: "__FILE__);
+    return croll__bumpAllocAlignedIn(bump, bump->_current, size, align);
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR void *croll_bumpAllocAlignedOrExpand(croll_BumpAlloc *bump, size_t size, size_t align) {
+    void *ptr = croll_bumpAllocAligned(bump, size, align);
+    if(ptr != NULL || size == 0) return ptr;
+
+    // Room for the worst-case padding, so the retry always fits
+    size_t rounded = croll_ALLOC_ALIGN(size);
+    croll_BumpAlloc *block = croll__bumpExpand(bump, rounded + align - 1);
+    croll_checkNullPtr(block) return NULL;
+    return croll__bumpAllocAlignedIn(bump, block, size, align);
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR void croll_bumpReset(croll_BumpAlloc *bump) {
+#ifdef CROLL_BUMP_STATS
+    bump->_stats.resets++;
+    bump->_live = 0;
+#endif
+    croll__bumpFreeChain(bump->_side);
+    bump->_side = NULL;
+    bump->_current = bump;
+    bump->offset = 0;
+    while(bump->_next != NULL) {
+        bump = bump->_next;
+        bump->offset = 0;
+    }
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR croll_BumpMark croll_bumpMark(croll_BumpAlloc *bump) {
+    return (croll_BumpMark){bump->_current, bump->_current->offset, bump->_side};
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR void croll_bumpRewind(croll_BumpAlloc *bump, croll_BumpMark mark) {
+    croll_ASSERT(mark.offset <= mark.block->offset || mark.block != bump->_current, "Bump mark is ahead of the arena at file: "__FILE__);
+    // Blocks past the current one are already empty. Running off the chain before reaching them
+    // means the mark's block is past the current one, i.e. the mark is older than a reset.
+    croll_BumpAlloc *end = bump->_current->_next;
+    croll_BumpAlloc *b = mark.block->_next;
+    for(; b != end && b != NULL; b = b->_next)
+        b->offset = 0;
+    croll_ASSERT(b == end, "Bump mark was taken before a reset at file: "__FILE__);
+    mark.block->offset = mark.offset;
+    bump->_current = mark.block;
+    // Side blocks are pushed in front, the ones made since the mark come first
+    while(bump->_side != NULL && bump->_side != mark._side) {
+        croll_BumpAlloc *side = bump->_side;
+        bump->_side = side->_next;
+        side->_next = NULL;
+        croll__bumpFreeChain(side);
+    }
+#ifdef CROLL_BUMP_STATS
+    bump->_live = 0;
+    for(croll_BumpAlloc *b = bump; b != mark.block->_next; b = b->_next)
+        bump->_live += b->offset;
+    for(croll_BumpAlloc *b = bump->_side; b != NULL; b = b->_next)
+        bump->_live += b->offset;
+#endif
+}
+
+// concurrent arena
+
+static croll__AtomicBlock *croll__atomicBlock(size_t size, croll__AtomicBlock *prev, size_t taken) {
+    croll__AtomicBlock *block = malloc(sizeof(croll__AtomicBlock) + size);
+    croll_checkNullPtr(block) return NULL;
+    atomic_init(&block->prev, prev);
+    block->size = size;
+    block->data = (croll_byte *)(block + 1);
+    atomic_init(&block->offset, taken);
+    return block;
+}
+
+__STATIC_FUNCTION croll_AtomicArena *croll_atomicArenaNew(size_t block_size) {
+    croll_AtomicArena *arena = aligned_alloc(CROLL_CACHE_LINE, sizeof(croll_AtomicArena));
+    croll_checkNullPtr(arena) return NULL;
+    arena->block_size = croll_ALLOC_ALIGN(block_size);
+    croll__AtomicBlock *first = croll__atomicBlock(arena->block_size, NULL, 0);
+    croll_checkNullPtr(first) {
+        free(arena);
+        return NULL;
+    }
+    atomic_init(&arena->current, first);
+    return arena;
+}
+
+// Stands in for the current block while the thread that filled it installs the next one
+#define CROLL__ATOMIC_INSTALLING ((croll__AtomicBlock *)&croll__atomicInstalling)
+static char croll__atomicInstalling;
+
+static croll__AtomicBlock *croll__atomicCurrent(croll_AtomicArena *arena) {
+    croll__AtomicBlock *block;
+    while((block = atomic_load_explicit(&arena->current, memory_order_acquire)) == CROLL__ATOMIC_INSTALLING) {
+#if defined(__unix__) || defined(__APPLE__)
+        sched_yield();
+#endif
+    }
+    return block;
+}
+
+__STATIC_FUNCTION void *croll_atomicArenaAlloc(croll_AtomicArena *arena, size_t size) {
+    if(size == 0) return NULL;
+    if(size & 0b111) size = croll_ALLOC_ALIGN(size);
+
+    if(size > arena->block_size / 4) {
+        // Own block, pushed right behind the current one
+        croll__AtomicBlock *block = croll__atomicCurrent(arena);
+        croll__AtomicBlock *big = croll__atomicBlock(size, atomic_load_explicit(&block->prev, memory_order_relaxed), size);
+        croll_checkNullPtr(big) return NULL;
+        croll__AtomicBlock *expected = atomic_load_explicit(&big->prev, memory_order_relaxed);
+        while(!atomic_compare_exchange_weak_explicit(&block->prev, &expected, big, memory_order_release, memory_order_relaxed))
+            atomic_store_explicit(&big->prev, expected, memory_order_relaxed);
+        return big->data;
+    }
+
+    for(;;) {
+        croll__AtomicBlock *block = croll__atomicCurrent(arena);
+        size_t offset = atomic_fetch_add_explicit(&block->offset, size, memory_order_relaxed);
+        if(offset + size <= block->size) return block->data + offset;
+
+        // Block is full: one thread claims the swap, the rest wait in croll__atomicCurrent and retry
+        if(!atomic_compare_exchange_strong_explicit(&arena->current, &block, CROLL__ATOMIC_INSTALLING,
+                                                    memory_order_acquire, memory_order_relaxed))
+            continue;
+        // The new block starts out holding this allocation
+        croll__AtomicBlock *fresh = croll__atomicBlock(arena->block_size, block, size);
+        atomic_store_explicit(&arena->current, fresh ? fresh : block, memory_order_release);
+        croll_checkNullPtr(fresh) return NULL;
+        return fresh->data;
+    }
+}
+
+__STATIC_FUNCTION void croll_atomicArenaReset(croll_AtomicArena *arena) {
+    croll__AtomicBlock *current = atomic_load_explicit(&arena->current, memory_order_relaxed);
+    croll__AtomicBlock *block = atomic_load_explicit(&current->prev, memory_order_relaxed);
+    while(block != NULL) {
+        croll__AtomicBlock *prev = atomic_load_explicit(&block->prev, memory_order_relaxed);
+        free(block);
+        block = prev;
+    }
+    atomic_store_explicit(&current->prev, NULL, memory_order_relaxed);
+    atomic_store_explicit(&current->offset, 0, memory_order_relaxed);
+}
+
+__STATIC_FUNCTION void croll_atomicArenaDestroy(croll_AtomicArena *arena) {
+    croll_checkNullPtr(arena) return;
+    croll_atomicArenaReset(arena);
+    free(atomic_load_explicit(&arena->current, memory_order_relaxed));
+    free(arena);
+}
+
+// scratch arenas
+
+static _Thread_local croll_BumpAlloc *croll__scratchArenas[2];
+
+__STATIC_FUNCTION croll_Scratch croll__scratchBegin(croll_BumpAlloc *const *conflicts, size_t count) {
+    for(size_t i = 0; i < 2; i++) {
+        croll_BumpAlloc *arena = croll__scratchArenas[i];
+        bool taken = false;
+        for(size_t c = 0; c < count && !taken; c++)
+            taken = arena != NULL && conflicts[c] == arena;
+        if(taken) continue;
+
+        if(arena == NULL) {
+            arena = croll__scratchArenas[i] = croll_bumpNew(CROLL_SCRATCH_SIZE);
+            croll_ASSERT(arena != NULL, "Failed to allocate scratch arena at file: "__FILE__);
+        }
+        return (croll_Scratch){arena, croll_bumpMark(arena)};
+    }
+    croll_ASSERT(false, "Both scratch arenas conflict at file: "__FILE__);
+    return (croll_Scratch){0};
+}
+
+__STATIC_FUNCTION void croll_scratchEnd(croll_Scratch scratch) {
+    croll_bumpRewind(scratch.arena, scratch.mark);
+}
+
+__STATIC_FUNCTION void croll_scratchRelease(void) {
+    for(size_t i = 0; i < 2; i++) {
+        croll_bumpDestroy(croll__scratchArenas[i]);
+        croll__scratchArenas[i] = NULL;
+    }
+}
+
+#ifdef CROLL_HAS_VARENA
+
+#define CROLL__HUGE_PAGE ((size_t)2 * 1024 * 1024)
+
+__STATIC_FUNCTION croll_VArena *croll_varenaNew(size_t reserve, int flags) {
+    croll_VArena *va = malloc(sizeof(croll_VArena));
+    croll_checkNullPtr(va) return NULL;
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t step = flags & CROLL_VARENA_HUGEPAGES ? CROLL__HUGE_PAGE : CROLL_VARENA_COMMIT_SIZE;
+    step = (step + page - 1) & ~(page - 1);
+    reserve = (reserve + step - 1) & ~(step - 1);
+
+    // Over-reserve by one step so the base can be aligned to it, then give back the slack
+    size_t mapped = reserve + step;
+    croll_byte *raw = mmap(NULL, mapped, PROT_NONE, MAP_PRIVATE | CROLL__MAP_ANON | CROLL__MAP_NORESERVE, -1, 0);
+    if(raw == MAP_FAILED) {
+        free(va);
+        return NULL;
+    }
+    croll_byte *base = (croll_byte *)(((uintptr_t)raw + step - 1) & ~(uintptr_t)(step - 1));
+    if(base > raw) munmap(raw, (size_t)(base - raw));
+    if(raw + mapped > base + reserve) munmap(base + reserve, (size_t)(raw + mapped - (base + reserve)));
+
+    *va = (croll_VArena){.base = base, .reserved = reserve, .commit_step = step, .flags = flags};
+    return va;
+}
+
+static bool croll__varenaCommit(croll_VArena *va, size_t end) {
+    if(end > va->reserved) return false;
+    size_t target = (end + va->commit_step - 1) & ~(va->commit_step - 1);
+    if(target > va->reserved) target = va->reserved;
+    if(mprotect(va->base + va->committed, target - va->committed, PROT_READ | PROT_WRITE) != 0) return false;
+#ifdef MADV_HUGEPAGE
+    if(va->flags & CROLL_VARENA_HUGEPAGES)
+        madvise(va->base + va->committed, target - va->committed, MADV_HUGEPAGE);
+#endif
+    va->committed = target;
+    return true;
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR void *croll_varenaAllocAligned(croll_VArena *va, size_t size, size_t align) {
+    croll_ASSERT(align && (align & (align - 1)) == 0, "Alignment must be a power of two at file: "__FILE__);
+    if(size == 0) return NULL;
+    size_t start = (va->offset + align - 1) & ~(align - 1);
+    if(start + size < start) return NULL;
+    if(start + size > va->committed && !croll__varenaCommit(va, start + size)) return NULL;
+    va->offset = start + size;
+    return va->base + start;
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR void *croll_varenaAlloc(croll_VArena *va, size_t size) {
+    return croll_varenaAllocAligned(va, size, 8);
+}
+
+__STATIC_FUNCTION void croll_varenaReset(croll_VArena *va) {
+    va->offset = 0;
+}
+
+__STATIC_FUNCTION void croll_varenaResetTrim(croll_VArena *va, size_t keep_bytes) {
+    va->offset = 0;
+    size_t keep = (keep_bytes + va->commit_step - 1) & ~(va->commit_step - 1);
+    if(keep >= va->committed) return;
+
+    madvise(va->base + keep, va->committed - keep, MADV_DONTNEED);
+    mprotect(va->base + keep, va->committed - keep, PROT_NONE);
+    va->committed = keep;
+}
+
+__STATIC_FUNCTION void croll_varenaResetAdaptive(croll_VArena *va, croll_BumpTrimPolicy *policy) {
+    croll_varenaResetTrim(va, croll_bumpTrimPolicyUpdate(policy, va->offset));
+}
+
+__STATIC_FUNCTION void croll_varenaDestroy(croll_VArena *va) {
+    croll_checkNullPtr(va) return;
+    munmap(va->base, va->reserved);
+    free(va);
+}
+
+#endif // CROLL_HAS_VARENA
+
+__STATIC_FUNCTION void croll_bumpResetTrim(croll_BumpAlloc *bump, size_t keep_bytes) {
+    croll_bumpReset(bump);
+    size_t kept = bump->size;
+    croll_BumpAlloc *last = bump;
+    while(last->_next != NULL && kept + last->_next->size <= keep_bytes) {
+        last = last->_next;
+        kept += last->size;
+    }
+    croll__bumpFreeChain(last->_next);
+    last->_next = NULL;
+}
+
+__STATIC_FUNCTION size_t croll_bumpTrimPolicyUpdate(croll_BumpTrimPolicy *policy, size_t used) {
+    double alpha = policy->alpha > 0 ? policy->alpha : 0.125;
+    double headroom = policy->headroom > 0 ? policy->headroom : 1.5;
+    // The first sample seeds the average instead of being pulled towards 0
+    if(policy->avg_used == 0) policy->avg_used = (double)used;
+    else policy->avg_used += alpha * ((double)used - policy->avg_used);
+    return (size_t)(policy->avg_used * headroom);
+}
+
+__STATIC_FUNCTION void croll_bumpResetAdaptive(croll_BumpAlloc *bump, croll_BumpTrimPolicy *policy) {
+    size_t used = 0;
+    for(croll_BumpAlloc *b = bump; b != NULL && b != bump->_current->_next; b = b->_next)
+        used += b->offset;
+    croll_bumpResetTrim(bump, croll_bumpTrimPolicyUpdate(policy, used));
+}
+
+__STATIC_FUNCTION croll_BumpStats croll_bumpStats(croll_BumpAlloc *bump) {
+    croll_BumpStats stats = {0};
+#ifdef CROLL_BUMP_STATS
+    stats = bump->_stats;
+#endif
+    bool past_current = false;
+    for(croll_BumpAlloc *b = bump; b != NULL; b = b->_next) {
+        stats.blocks++;
+        stats.reserved += b->size;
+        stats.in_use += b->offset;
+        // Blocks before the current one were left behind with whatever did not fit
+        if(b == bump->_current) past_current = true;
+        else if(!past_current) stats.tail_waste += b->size - b->offset;
+    }
+    for(croll_BumpAlloc *b = bump->_side; b != NULL; b = b->_next) {
+        stats.blocks++;
+        stats.reserved += b->size;
+        stats.in_use += b->offset;
+    }
+    return stats;
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR void croll_bumpDestroy(croll_BumpAlloc *bump) {
+    croll_checkNullPtr(bump) return;
+    croll__bumpFreeChain(bump->_side);
+    croll__bumpFreeChain(bump);
+}
+
+// Djb2 hash function
+__STATIC_FUNCTION size_t croll_hashDjb2(const char *str) {
+    size_t hash = 5381;
+    int c;
+
+    while ((c = *str++))
+        hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+
+    return hash;
+}
+
+// One block of chunks, without the head's block index
+static croll_PoolAlloc *croll__poolBlockNew(size_t pool_size, size_t chunk_size) {
+    /*
+    should somewhat loke like the following:
+    struct chunk {
+        union {
+            void* next;
+            void data[chunk_size];
+        };
+        croll_PoolAlloc *allocator;
+    };
+    */
+    croll_PoolAlloc *pool = malloc(sizeof(croll_PoolAlloc));
+    croll_checkNullPtr(pool) return NULL;
+
+    // Chunks are carved lazily, so the block is not written (or faulted in) here
+    pool->chunks = malloc(pool_size * chunk_size);
+    croll_checkNullPtr(pool->chunks) {
+        free(pool);
+        return NULL;
+    }
+
+    pool->_next = NULL;
+    pool->free_chunks = NULL;
+    pool->_carve = pool->chunks;
+    pool->_carve_end = pool->_carve + pool_size * chunk_size;
+    pool->_blocks.data = NULL;
+    pool->_blocks.len = pool->_blocks.cap = 0;
+    pool->chunk_size = chunk_size;
+    pool->size = pool_size;
+
+    return pool;
+}
+
+// Index of the first block whose memory starts after addr
+static size_t croll__poolBlockAfter(const croll_PoolAlloc *pool, size_t addr) {
+    size_t lo = 0, n = pool->_blocks.len;
+    while(n > 0) {
+        size_t half = n / 2;
+        if((size_t)pool->_blocks.data[lo + half]->chunks <= addr) {
+            lo += half + 1;
+            n -= half + 1;
+        } else {
+            n = half;
+        }
+    }
+    return lo;
+}
+
+static void croll__poolIndexBlock(croll_PoolAlloc *pool, croll_PoolAlloc *block) {
+    size_t at = croll__poolBlockAfter(pool, (size_t)block->chunks);
+    croll_daAppend(&pool->_blocks, block);
+    memmove(pool->_blocks.data + at + 1, pool->_blocks.data + at, (pool->_blocks.len - at - 1) * sizeof(croll_PoolAlloc *));
+    pool->_blocks.data[at] = block;
+}
+
+__STATIC_FUNCTION croll_PoolAlloc *croll_poolNew(size_t pool_size, size_t chunk_size) {
+    if(pool_size == 0 || chunk_size < sizeof(void*))
+    return NULL;
+    chunk_size = croll_ALLOC_ALIGN(chunk_size);
+
+    croll_PoolAlloc *pool = croll__poolBlockNew(pool_size, chunk_size);
+    croll_checkNullPtr(pool) return NULL;
+    croll__poolIndexBlock(pool, pool);
+    return pool;
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR void croll_poolDestroy(croll_PoolAlloc *pool) {
+    croll_checkNullPtr(pool) return;
+    croll_daFree(&pool->_blocks);
+    while(pool != NULL) {
+        croll_PoolAlloc *next = pool->_next;
+        free(pool->chunks);
+        free(pool);
+        pool = next;
+    } 
+}
+
+// Adds an untouched block and makes it the one chunks are carved from
+static bool croll__poolGrow(croll_PoolAlloc *pool) {
+    croll_PoolAlloc *block = croll__poolBlockNew(pool->size, pool->chunk_size);
+    croll_checkNullPtr(block) return false;
+    croll__poolIndexBlock(pool, block);
+    block->_next = pool->_next;
+    pool->_next = block;
+    pool->_carve = block->_carve;
+    pool->_carve_end = block->_carve_end;
+    return true;
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR void *croll_poolAlloc(croll_PoolAlloc *pool) {
+    croll_checkNullPtr(pool) return NULL;
+
+    // Reason why chunk_size >= sizeof(void*)
+    void *chunk = pool->free_chunks;
+    if(chunk != NULL) {
+        pool->free_chunks = *(void**)chunk;
+        return chunk;
+    }
+
+    if(pool->_carve == pool->_carve_end && !croll__poolGrow(pool))
+        return NULL;
+    chunk = pool->_carve;
+    pool->_carve += pool->chunk_size;
+    return chunk;
+}
+
+__STATIC_FUNCTION bool croll_poolOwns(const croll_PoolAlloc *pool, const void *ptr) {
+    croll_checkNullPtr(pool) return false;
+    size_t addr = (size_t)ptr;
+    size_t at = croll__poolBlockAfter(pool, addr);
+    if(at == 0) return false;
+
+    const croll_PoolAlloc *block = pool->_blocks.data[at - 1];
+    size_t offset = addr - (size_t)block->chunks;
+    if(offset >= block->size * pool->chunk_size || offset % pool->chunk_size != 0) return false;
+    // The rest of the newest block was never handed out
+    return addr < (size_t)pool->_carve || addr >= (size_t)pool->_carve_end;
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR void croll_poolFree(croll_PoolAlloc *pool, void *chunk) {
+    croll_checkNullPtr(pool) return;
+    croll_checkNullPtr(chunk) return;
+#ifdef CROLL__POOL_VALIDATE
+    if(!croll_poolOwns(pool, chunk)) {
+        croll_ASSERT(false, "Freed pointer does not belong to the pool at file: "__FILE__);
+        croll_logError("croll_poolFree: %p does not belong to the pool, ignored\n", chunk);
+        return;
+    }
+#endif
+
+    *(void**)chunk = pool->free_chunks;
+    pool->free_chunks = chunk;
+}
+
+
+// 2D grid
+
+#define CROLL__GRID_BLOCK 32
+
+#define CROLL__TRANSPOSE_BLOCKED(T)                                                          \
+    do {                                                                                     \
+        T *d = dst;                                                                          \
+        const T *s = src;                                                                    \
+        for(size_t r0 = 0; r0 < rows; r0 += CROLL__GRID_BLOCK)                               \
+            for(size_t c0 = 0; c0 < cols; c0 += CROLL__GRID_BLOCK) {                         \
+                size_t r1 = r0 + CROLL__GRID_BLOCK < rows ? r0 + CROLL__GRID_BLOCK : rows;   \
+                size_t c1 = c0 + CROLL__GRID_BLOCK < cols ? c0 + CROLL__GRID_BLOCK : cols;   \
+                for(size_t r = r0; r < r1; r++)                                              \
+                    for(size_t c = c0; c < c1; c++)                                          \
+                        d[c * dst_stride + r] = s[r * src_stride + c];                       \
+            }                                                                                \
+    } while(0)
+
+__STATIC_FUNCTION void croll__gridTranspose(void *dst, const void *src, size_t rows, size_t cols,
+                                            size_t src_stride, size_t dst_stride, size_t elem_size) {
+    switch(elem_size) {
+        case 1: CROLL__TRANSPOSE_BLOCKED(croll_u8); return;
+        case 2: CROLL__TRANSPOSE_BLOCKED(croll_u16); return;
+        case 4: CROLL__TRANSPOSE_BLOCKED(croll_u32); return;
+        case 8: CROLL__TRANSPOSE_BLOCKED(croll_u64); return;
+    }
+
+    croll_byte *d = dst;
+    const croll_byte *s = src;
+    for(size_t r0 = 0; r0 < rows; r0 += CROLL__GRID_BLOCK)
+        for(size_t c0 = 0; c0 < cols; c0 += CROLL__GRID_BLOCK) {
+            size_t r1 = r0 + CROLL__GRID_BLOCK < rows ? r0 + CROLL__GRID_BLOCK : rows;
+            size_t c1 = c0 + CROLL__GRID_BLOCK < cols ? c0 + CROLL__GRID_BLOCK : cols;
+            for(size_t r = r0; r < r1; r++)
+                for(size_t c = c0; c < c1; c++)
+                    memcpy(d + (c * dst_stride + r) * elem_size, s + (r * src_stride + c) * elem_size, elem_size);
+        }
+}
+
+// ring buffer
+
+__STATIC_FUNCTION croll_Ring *croll_ringNew(size_t capacity, size_t elem_size) {
+    if(capacity == 0 || elem_size == 0) return NULL;
+    // Past the top power of two the round-up would wrap to 0
+    if(capacity > SIZE_MAX / 2 + 1) return NULL;
+    size_t cap = 1;
+    while(cap < capacity) cap <<= 1;
+    if(cap > SIZE_MAX / elem_size) return NULL;
+
+    croll_Ring *ring = aligned_alloc(CROLL_CACHE_LINE, sizeof(croll_Ring));
+    croll_checkNullPtr(ring) return NULL;
+    memset(ring, 0, sizeof(croll_Ring));
+
+    ring->data = malloc(cap * elem_size);
+    croll_checkNullPtr(ring->data) {
+        free(ring);
+        return NULL;
+    }
+    ring->mask = cap - 1;
+    ring->elem_size = elem_size;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+
+    return ring;
+}
+
+// Copies count elements between a linear buffer and the ring starting at index, wrapping once if needed
+static __CROLL_INLINE_ATTR void croll__ringCopy(croll_Ring *ring, size_t index, void *buf, size_t count, bool into_ring) {
+    size_t start = index & ring->mask;
+    size_t first = ring->mask + 1 - start;
+    if(first > count) first = count;
+
+    croll_byte *slot = ring->data + start * ring->elem_size;
+    size_t first_bytes = first * ring->elem_size;
+    size_t rest_bytes = (count - first) * ring->elem_size;
+    if(into_ring) {
+        memcpy(slot, buf, first_bytes);
+        memcpy(ring->data, (croll_byte *)buf + first_bytes, rest_bytes);
+    } else {
+        memcpy(buf, slot, first_bytes);
+        memcpy((croll_byte *)buf + first_bytes, ring->data, rest_bytes);
+    }
+}
+
+__STATIC_FUNCTION size_t croll_ringPushBatch(croll_Ring *ring, const void *items, size_t count) {
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t cap = ring->mask + 1;
+
+    size_t free_slots = cap - (tail - ring->_head_cache);
+    if(free_slots < count) {
+        ring->_head_cache = atomic_load_explicit(&ring->head, memory_order_acquire);
+        free_slots = cap - (tail - ring->_head_cache);
+    }
+    if(count > free_slots) count = free_slots;
+    if(count == 0) return 0;
+
+    croll__ringCopy(ring, tail, (void *)items, count, true);
+    atomic_store_explicit(&ring->tail, tail + count, memory_order_release);
+    return count;
+}
+
+__STATIC_FUNCTION size_t croll_ringPopBatch(croll_Ring *ring, void *out, size_t max) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    size_t available = ring->_tail_cache - head;
+    if(available < max) {
+        ring->_tail_cache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        available = ring->_tail_cache - head;
+    }
+    if(max > available) max = available;
+    if(max == 0) return 0;
+
+    croll__ringCopy(ring, head, out, max, false);
+    atomic_store_explicit(&ring->head, head + max, memory_order_release);
+    return max;
+}
+
+__STATIC_FUNCTION bool croll_ringPush(croll_Ring *ring, const void *item) {
+    return croll_ringPushBatch(ring, item, 1) == 1;
+}
+
+__STATIC_FUNCTION bool croll_ringPop(croll_Ring *ring, void *out) {
+    return croll_ringPopBatch(ring, out, 1) == 1;
+}
+
+__STATIC_FUNCTION size_t croll_ringLen(croll_Ring *ring) {
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return tail - head;
+}
+
+__STATIC_FUNCTION void croll_ringDestroy(croll_Ring *ring) {
+    croll_checkNullPtr(ring) return;
+    free(ring->data);
+    free(ring);
+}
+
+// MPMC queue
+
+// Sleeps while *addr == expected, spurious wake-ups are allowed
+__STATIC_FUNCTION void croll__futexWait(_Atomic croll_u32 *addr, croll_u32 expected) {
+#if defined(CROLL__HAS_FUTEX)
+    syscall(SYS_futex, (croll_u32 *)addr, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+#elif defined(__unix__) || defined(__APPLE__)
+    croll_UNUSED(addr);
+    croll_UNUSED(expected);
+    sched_yield();
+#else
+    croll_UNUSED(addr);
+    croll_UNUSED(expected);
+#endif
+}
+
+__STATIC_FUNCTION void croll__futexWake(_Atomic croll_u32 *addr, int count) {
+#if defined(CROLL__HAS_FUTEX)
+    syscall(SYS_futex, (croll_u32 *)addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+#else
+    croll_UNUSED(addr);
+    croll_UNUSED(count);
+#endif
+}
+
+#define CROLL__MPMC_SPINS 64
+
+#define croll__mpmcCell(q, pos) ((q)->cells + ((pos) & (q)->mask) * (q)->cell_size)
+#define croll__mpmcSeq(cell) ((_Atomic size_t *)(cell))
+#define croll__mpmcData(cell) ((cell) + sizeof(size_t))
+
+__STATIC_FUNCTION croll_MpmcQueue *croll_mpmcNew(size_t capacity, size_t elem_size) {
+    if(capacity == 0 || elem_size == 0) return NULL;
+    // Past the top power of two the round-up would wrap to 0
+    if(capacity > SIZE_MAX / 2 + 1 || elem_size > SIZE_MAX / 2) return NULL;
+    size_t cap = 2;
+    while(cap < capacity) cap <<= 1;
+    if(cap > (SIZE_MAX - CROLL_CACHE_LINE) / croll_ALLOC_ALIGN(sizeof(size_t) + elem_size)) return NULL;
+
+    croll_MpmcQueue *q = aligned_alloc(CROLL_CACHE_LINE, sizeof(croll_MpmcQueue));
+    croll_checkNullPtr(q) return NULL;
+    memset(q, 0, sizeof(croll_MpmcQueue));
+
+    q->elem_size = elem_size;
+    q->cell_size = croll_ALLOC_ALIGN(sizeof(size_t) + elem_size);
+    q->mask = cap - 1;
+    // aligned_alloc wants a size that is a multiple of the alignment
+    size_t bytes = (cap * q->cell_size + CROLL_CACHE_LINE - 1) & ~(size_t)(CROLL_CACHE_LINE - 1);
+    q->cells = aligned_alloc(CROLL_CACHE_LINE, bytes);
+    croll_checkNullPtr(q->cells) {
+        free(q);
+        return NULL;
+    }
+
+    for(size_t i = 0; i < cap; i++)
+        atomic_init(croll__mpmcSeq(croll__mpmcCell(q, i)), i);
+    atomic_init(&q->enqueue_pos, 0);
+    atomic_init(&q->dequeue_pos, 0);
+    atomic_init(&q->_not_empty, 0);
+    atomic_init(&q->_pop_waiters, 0);
+    atomic_init(&q->_not_full, 0);
+    atomic_init(&q->_push_waiters, 0);
+
+    return q;
+}
+
+// Called after a successful operation, wakes one thread parked on the other side if there is any.
+// The fence pairs with the one in croll__mpmcPark: either we see the waiter or it sees our element,
+// so a parked thread can sleep without a timeout.
+static __CROLL_INLINE_ATTR void croll__mpmcNotify(_Atomic croll_u32 *event, _Atomic croll_u32 *waiters) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if(atomic_load_explicit(waiters, memory_order_relaxed) != 0) {
+        atomic_fetch_add_explicit(event, 1, memory_order_release);
+        croll__futexWake(event, 1);
+    }
+}
+
+__STATIC_FUNCTION bool croll_mpmcTryPush(croll_MpmcQueue *q, const void *item) {
+    size_t pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+    croll_byte *cell;
+    for(;;) {
+        cell = croll__mpmcCell(q, pos);
+        size_t seq = atomic_load_explicit(croll__mpmcSeq(cell), memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if(diff == 0) {
+            if(atomic_compare_exchange_weak_explicit(&q->enqueue_pos, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if(diff < 0) {
+            return false; // full
+        } else {
+            pos = atomic_load_explicit(&q->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    memcpy(croll__mpmcData(cell), item, q->elem_size);
+    atomic_store_explicit(croll__mpmcSeq(cell), pos + 1, memory_order_release);
+    croll__mpmcNotify(&q->_not_empty, &q->_pop_waiters);
+    return true;
+}
+
+__STATIC_FUNCTION bool croll_mpmcTryPop(croll_MpmcQueue *q, void *out) {
+    size_t pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+    croll_byte *cell;
+    for(;;) {
+        cell = croll__mpmcCell(q, pos);
+        size_t seq = atomic_load_explicit(croll__mpmcSeq(cell), memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+        if(diff == 0) {
+            if(atomic_compare_exchange_weak_explicit(&q->dequeue_pos, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if(diff < 0) {
+            return false; // empty
+        } else {
+            pos = atomic_load_explicit(&q->dequeue_pos, memory_order_relaxed);
+        }
+    }
+
+    memcpy(out, croll__mpmcData(cell), q->elem_size);
+    atomic_store_explicit(croll__mpmcSeq(cell), pos + q->mask + 1, memory_order_release);
+    croll__mpmcNotify(&q->_not_full, &q->_push_waiters);
+    return true;
+}
+
+// Registers as a waiter, retries once and sleeps until the other side bumps `event`
+__STATIC_FUNCTION bool croll__mpmcPark(croll_MpmcQueue *q, _Atomic croll_u32 *event, _Atomic croll_u32 *waiters, bool push, void *buf) {
+    atomic_fetch_add_explicit(waiters, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    croll_u32 epoch = atomic_load_explicit(event, memory_order_acquire);
+
+    bool done = push ? croll_mpmcTryPush(q, buf) : croll_mpmcTryPop(q, buf);
+    if(!done) croll__futexWait(event, epoch);
+
+    atomic_fetch_sub_explicit(waiters, 1, memory_order_relaxed);
+    return done;
+}
+
+__STATIC_FUNCTION void croll_mpmcPush(croll_MpmcQueue *q, const void *item) {
+    for(;;) {
+        for(int spin = 0; spin < CROLL__MPMC_SPINS; spin++)
+            if(croll_mpmcTryPush(q, item)) return;
+        if(croll__mpmcPark(q, &q->_not_full, &q->_push_waiters, true, (void *)item)) return;
+    }
+}
+
+__STATIC_FUNCTION void croll_mpmcPop(croll_MpmcQueue *q, void *out) {
+    for(;;) {
+        for(int spin = 0; spin < CROLL__MPMC_SPINS; spin++)
+            if(croll_mpmcTryPop(q, out)) return;
+        if(croll__mpmcPark(q, &q->_not_empty, &q->_pop_waiters, false, out)) return;
+    }
+}
+
+__STATIC_FUNCTION void croll_mpmcDestroy(croll_MpmcQueue *q) {
+    croll_checkNullPtr(q) return;
+    free(q->cells);
+    free(q);
+}
+
+// heap
+
+#define CROLL__HEAP_DEFAULT_ARITY 4
+#define CROLL__HEAP_ABSENT SIZE_MAX
+
+static __CROLL_INLINE_ATTR size_t croll__heapShift(const croll_Heap *heap) {
+    size_t arity = heap->arity ? heap->arity : CROLL__HEAP_DEFAULT_ARITY;
+    croll_ASSERT((arity & (arity - 1)) == 0 && arity >= 2, "Heap arity must be 0 or a power of two >= 2 (2, 4, 8, ...) at file: "__FILE__);
+    return croll__log2(arity);
+}
+
+// Writes a node into slot i, keeping the index map in sync
+static __CROLL_INLINE_ATTR void croll__heapPlace(croll_Heap *heap, size_t i, croll_HeapNode node) {
+    heap->nodes.data[i] = node;
+    if(heap->indexed) heap->positions.data[node.value] = i;
+}
+
+// Both sifts move a hole instead of swapping, so each level costs one store
+__STATIC_FUNCTION void croll__heapSiftUp(croll_Heap *heap, size_t i, croll_HeapNode node, size_t shift) {
+    while(i > 0) {
+        size_t parent = (i - 1) >> shift;
+        if(heap->nodes.data[parent].key <= node.key) break;
+        croll__heapPlace(heap, i, heap->nodes.data[parent]);
+        i = parent;
+    }
+    croll__heapPlace(heap, i, node);
+}
+
+__STATIC_FUNCTION void croll__heapSiftDown(croll_Heap *heap, size_t i, croll_HeapNode node, size_t shift) {
+    croll_HeapNode *nodes = heap->nodes.data;
+    size_t len = heap->nodes.len;
+    size_t arity = (size_t)1 << shift;
+    for(;;) {
+        size_t first = (i << shift) + 1;
+        if(first >= len) break;
+        size_t last = first + arity < len ? first + arity : len;
+
+        size_t best = first;
+        for(size_t c = first + 1; c < last; c++)
+            if(nodes[c].key < nodes[best].key) best = c;
+
+        if(node.key <= nodes[best].key) break;
+        croll__heapPlace(heap, i, nodes[best]);
+        i = best;
+    }
+    croll__heapPlace(heap, i, node);
+}
+
+static __CROLL_INLINE_ATTR void croll__heapTrack(croll_Heap *heap, croll_u64 value) {
+    if(value >= heap->positions.len) {
+        size_t old_len = heap->positions.len;
+        croll_daReserve(&heap->positions, value + 1);
+        for(size_t i = old_len; i <= value; i++) heap->positions.data[i] = CROLL__HEAP_ABSENT;
+        heap->positions.len = value + 1;
+    }
+}
+
+__STATIC_FUNCTION void croll_heapPush(croll_Heap *heap, croll_u64 key, croll_u64 value) {
+    if(heap->indexed) {
+        croll__heapTrack(heap, value);
+        croll_ASSERT(heap->positions.data[value] == CROLL__HEAP_ABSENT, "Value is already in the heap at file: "__FILE__);
+    }
+    croll_daReserve(&heap->nodes, heap->nodes.len + 1);
+    heap->nodes.len++;
+    croll__heapSiftUp(heap, heap->nodes.len - 1, (croll_HeapNode){key, value}, croll__heapShift(heap));
+}
+
+__STATIC_FUNCTION croll_HeapNode croll_heapPeek(const croll_Heap *heap) {
+    croll_ASSERT(heap->nodes.len > 0, "Heap is empty at file: "__FILE__);
+    return heap->nodes.data[0];
+}
+
+__STATIC_FUNCTION croll_HeapNode croll_heapPop(croll_Heap *heap) {
+    croll_ASSERT(heap->nodes.len > 0, "Heap is empty at file: "__FILE__);
+    croll_HeapNode top = heap->nodes.data[0];
+    if(heap->indexed) heap->positions.data[top.value] = CROLL__HEAP_ABSENT;
+
+    croll_HeapNode last = heap->nodes.data[--heap->nodes.len];
+    if(heap->nodes.len > 0)
+        croll__heapSiftDown(heap, 0, last, croll__heapShift(heap));
+    return top;
+}
+
+__STATIC_FUNCTION void croll_heapify(croll_Heap *heap) {
+    size_t len = heap->nodes.len;
+    size_t shift = croll__heapShift(heap);
+    if(heap->indexed) {
+        for(size_t i = 0; i < len; i++) {
+            croll__heapTrack(heap, heap->nodes.data[i].value);
+            heap->positions.data[heap->nodes.data[i].value] = i;
+        }
+    }
+    if(len < 2) return;
+
+    // every node past the last parent is already a valid heap of size 1
+    for(size_t i = ((len - 2) >> shift) + 1; i-- > 0;)
+        croll__heapSiftDown(heap, i, heap->nodes.data[i], shift);
+}
+
+__STATIC_FUNCTION bool croll_heapContains(const croll_Heap *heap, croll_u64 value) {
+    croll_ASSERT(heap->indexed, "Heap is not indexed at file: "__FILE__);
+    return value < heap->positions.len && heap->positions.data[value] != CROLL__HEAP_ABSENT;
+}
+
+__STATIC_FUNCTION bool croll_heapDecreaseKey(croll_Heap *heap, croll_u64 value, croll_u64 key) {
+    if(!croll_heapContains(heap, value)) return false;
+    size_t i = heap->positions.data[value];
+    if(key > heap->nodes.data[i].key) return false;
+    croll__heapSiftUp(heap, i, (croll_HeapNode){key, value}, croll__heapShift(heap));
+    return true;
+}
+
+__STATIC_FUNCTION void croll_heapFree(croll_Heap *heap) {
+    croll_daFree(&heap->nodes);
+    croll_daFree(&heap->positions);
+}
+
+// bitset
+
+#define CROLL__RANK_BLOCK_WORDS 8
+
+__STATIC_FUNCTION croll_Bitset croll_bitsetNew(size_t nbits) {
+    croll_Bitset bs = {0};
+    bs.nwords = (nbits + 63) / 64;
+    bs.words = calloc(bs.nwords ? bs.nwords : 1, sizeof(croll_u64));
+    croll_checkNullPtr(bs.words) return (croll_Bitset){0};
+    bs.nbits = nbits;
+    return bs;
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR void croll_bitsetSet(croll_Bitset *bs, size_t i) {
+    croll_ASSERT(i < bs->nbits, "Bit index out of range at file: "__FILE__);
+    bs->words[i >> 6] |= (croll_u64)1 << (i & 63);
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR void croll_bitsetClear(croll_Bitset *bs, size_t i) {
+    croll_ASSERT(i < bs->nbits, "Bit index out of range at file: "__FILE__);
+    bs->words[i >> 6] &= ~((croll_u64)1 << (i & 63));
+}
+
+__STATIC_FUNCTION __CROLL_INLINE_ATTR bool croll_bitsetTest(const croll_Bitset *bs, size_t i) {
+    croll_ASSERT(i < bs->nbits, "Bit index out of range at file: "__FILE__);
+    return (bs->words[i >> 6] >> (i & 63)) & 1;
+}
+
+enum { CROLL__BITS_AND, CROLL__BITS_OR, CROLL__BITS_XOR, CROLL__BITS_ANDNOT };
+
+__STATIC_FUNCTION void croll__bitsetOpScalar(croll_u64 *dst, const croll_u64 *a, const croll_u64 *b, size_t n, int op) {
+    switch(op) {
+        case CROLL__BITS_AND:    for(size_t i = 0; i < n; i++) dst[i] = a[i] & b[i]; break;
+        case CROLL__BITS_OR:     for(size_t i = 0; i < n; i++) dst[i] = a[i] | b[i]; break;
+        case CROLL__BITS_XOR:    for(size_t i = 0; i < n; i++) dst[i] = a[i] ^ b[i]; break;
+        case CROLL__BITS_ANDNOT: for(size_t i = 0; i < n; i++) dst[i] = a[i] & ~b[i]; break;
+    }
+}
+
+__STATIC_FUNCTION size_t croll__popcountScalar(const croll_u64 *w, size_t n) {
+    size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0, i = 0;
+    for(; i + 4 <= n; i += 4) {
+        c0 += croll__popcount64(w[i]);
+        c1 += croll__popcount64(w[i + 1]);
+        c2 += croll__popcount64(w[i + 2]);
+        c3 += croll__popcount64(w[i + 3]);
+    }
+    for(; i < n; i++) c0 += croll__popcount64(w[i]);
+    return c0 + c1 + c2 + c3;
+}
+
+#ifdef CROLL__X86_SIMD
+#define CROLL__BITSET_OP_AVX2(intrin)                                                        \
+    for(; i + 8 <= n; i += 8) {                                                              \
+        croll__st256(dst + i, intrin(croll__ld256(a + i), croll__ld256(b + i)));             \
+        croll__st256(dst + i + 4, intrin(croll__ld256(a + i + 4), croll__ld256(b + i + 4))); \
+    }
+
+static __attribute__((target("avx2"))) void croll__bitsetOpAvx2(croll_u64 *dst, const croll_u64 *a, const croll_u64 *b, size_t n, int op) {
+    size_t i = 0;
+    switch(op) {
+        case CROLL__BITS_AND: CROLL__BITSET_OP_AVX2(_mm256_and_si256) break;
+        case CROLL__BITS_OR:  CROLL__BITSET_OP_AVX2(_mm256_or_si256) break;
+        case CROLL__BITS_XOR: CROLL__BITSET_OP_AVX2(_mm256_xor_si256) break;
+        // _mm256_andnot_si256 negates its first operand
+        case CROLL__BITS_ANDNOT:
+            for(; i + 4 <= n; i += 4)
+                croll__st256(dst + i, _mm256_andnot_si256(croll__ld256(b + i), croll__ld256(a + i)));
+            break;
+    }
+    croll__bitsetOpScalar(dst + i, a + i, b + i, n - i, op);
+}
+
+#define croll__bitsetOpSse croll__bitsetOpScalar
+
+// Nibble lookup with pshufb, byte counts summed into 64-bit lanes with sad (Mula et al.)
+static __attribute__((target("avx2"))) size_t croll__popcountAvx2(const croll_u64 *w, size_t n) {
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i acc0 = zero, acc1 = zero;
+    size_t i = 0;
+    for(; i + 8 <= n; i += 8) {
+        __m256i v0 = croll__ld256(w + i), v1 = croll__ld256(w + i + 4);
+        __m256i c0 = _mm256_add_epi8(_mm256_shuffle_epi8(lut, _mm256_and_si256(v0, low)),
+                                     _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v0, 4), low)));
+        __m256i c1 = _mm256_add_epi8(_mm256_shuffle_epi8(lut, _mm256_and_si256(v1, low)),
+                                     _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v1, 4), low)));
+        acc0 = _mm256_add_epi64(acc0, _mm256_sad_epu8(c0, zero));
+        acc1 = _mm256_add_epi64(acc1, _mm256_sad_epu8(c1, zero));
+    }
+    croll_u64 lanes[4];
+    croll__st256(lanes, _mm256_add_epi64(acc0, acc1));
+    return (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]) + croll__popcountScalar(w + i, n - i);
+}
+
+static __attribute__((target("popcnt"))) size_t croll__popcountSse(const croll_u64 *w, size_t n) {
+    size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0, i = 0;
+    for(; i + 4 <= n; i += 4) {
+        c0 += (size_t)__builtin_popcountll(w[i]);
+        c1 += (size_t)__builtin_popcountll(w[i + 1]);
+        c2 += (size_t)__builtin_popcountll(w[i + 2]);
+        c3 += (size_t)__builtin_popcountll(w[i + 3]);
+    }
+    for(; i < n; i++) c0 += (size_t)__builtin_popcountll(w[i]);
+    return c0 + c1 + c2 + c3;
+}
+#endif // CROLL__X86_SIMD
+
+__STATIC_FUNCTION void croll__bitsetOp(croll_Bitset *dst, const croll_Bitset *a, const croll_Bitset *b, int op) {
+    croll_ASSERT(dst->nbits == a->nbits && a->nbits == b->nbits, "Bitsets must have the same size at file: "__FILE__);
+    CROLL__SIMD_DISPATCH_VOID(croll__bitsetOp, dst->words, a->words, b->words, a->nwords, op);
+}
+
+__STATIC_FUNCTION void croll_bitsetAnd(croll_Bitset *dst, const croll_Bitset *a, const croll_Bitset *b) {
+    croll__bitsetOp(dst, a, b, CROLL__BITS_AND);
+}
+
+__STATIC_FUNCTION void croll_bitsetOr(croll_Bitset *dst, const croll_Bitset *a, const croll_Bitset *b) {
+    croll__bitsetOp(dst, a, b, CROLL__BITS_OR);
+}
+
+__STATIC_FUNCTION void croll_bitsetXor(croll_Bitset *dst, const croll_Bitset *a, const croll_Bitset *b) {
+    croll__bitsetOp(dst, a, b, CROLL__BITS_XOR);
+}
+
+__STATIC_FUNCTION void croll_bitsetAndNot(croll_Bitset *dst, const croll_Bitset *a, const croll_Bitset *b) {
+    croll__bitsetOp(dst, a, b, CROLL__BITS_ANDNOT);
+}
+
+__STATIC_FUNCTION size_t croll__popcountWords(const croll_u64 *words, size_t n) {
+    CROLL__SIMD_DISPATCH(croll__popcount, words, n);
+}
+
+__STATIC_FUNCTION size_t croll_bitsetCount(const croll_Bitset *bs) {
+    return croll__popcountWords(bs->words, bs->nwords);
+}
+
+__STATIC_FUNCTION size_t croll_bitsetNext(const croll_Bitset *bs, size_t from) {
+    if(from >= bs->nbits) return bs->nbits;
+    size_t w = from >> 6;
+    croll_u64 word = bs->words[w] & (~(croll_u64)0 << (from & 63));
+    while(word == 0) {
+        if(++w >= bs->nwords) return bs->nbits;
+        word = bs->words[w];
+    }
+    return (w << 6) + croll__ctz64(word);
+}
+
+__STATIC_FUNCTION bool croll_bitsetBuildRank(croll_Bitset *bs) {
+    size_t nblocks = (bs->nwords + CROLL__RANK_BLOCK_WORDS - 1) / CROLL__RANK_BLOCK_WORDS;
+    croll_u64 *rank = realloc(bs->_rank, (nblocks + 1) * sizeof(croll_u64));
+    croll_checkNullPtr(rank) return false;
+
+    croll_u64 total = 0;
+    for(size_t b = 0; b < nblocks; b++) {
+        rank[b] = total;
+        size_t first = b * CROLL__RANK_BLOCK_WORDS;
+        size_t count = bs->nwords - first < CROLL__RANK_BLOCK_WORDS ? bs->nwords - first : CROLL__RANK_BLOCK_WORDS;
+        total += croll__popcountScalar(bs->words + first, count);
+    }
+    rank[nblocks] = total;
+    bs->_rank = rank;
+    return true;
+}
+
+__STATIC_FUNCTION size_t croll_bitsetRank(const croll_Bitset *bs, size_t i) {
+    croll_ASSERT(bs->_rank != NULL, "Rank index not built at file: "__FILE__);
+    croll_ASSERT(i <= bs->nbits, "Bit index out of range at file: "__FILE__);
+    size_t w = i >> 6;
+    size_t block = w / CROLL__RANK_BLOCK_WORDS;
+    size_t r = (size_t)bs->_rank[block];
+    for(size_t j = block * CROLL__RANK_BLOCK_WORDS; j < w; j++)
+        r += croll__popcount64(bs->words[j]);
+    if(i & 63)
+        r += croll__popcount64(bs->words[w] & (((croll_u64)1 << (i & 63)) - 1));
+    return r;
+}
+
+__STATIC_FUNCTION size_t croll_bitsetSelect(const croll_Bitset *bs, size_t k) {
+    croll_ASSERT(bs->_rank != NULL, "Rank index not built at file: "__FILE__);
+    size_t nblocks = (bs->nwords + CROLL__RANK_BLOCK_WORDS - 1) / CROLL__RANK_BLOCK_WORDS;
+    if(k >= bs->_rank[nblocks]) return bs->nbits;
+
+    // last block whose running count is <= k
+    size_t lo = 0, hi = nblocks;
+    while(hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if(bs->_rank[mid] <= k) lo = mid;
+        else hi = mid;
+    }
+
+    k -= (size_t)bs->_rank[lo];
+    size_t w = lo * CROLL__RANK_BLOCK_WORDS;
+    for(;; w++) {
+        size_t count = croll__popcount64(bs->words[w]);
+        if(k < count) break;
+        k -= count;
+    }
+
+    croll_u64 word = bs->words[w];
+    while(k--) word &= word - 1;
+    return (w << 6) + croll__ctz64(word);
+}
+
+__STATIC_FUNCTION void croll_bitsetFree(croll_Bitset *bs) {
+    free(bs->words);
+    free(bs->_rank);
+    *bs = (croll_Bitset){0};
+}
+
+// search array
+
+#define CROLL__SEARCH_BATCH 8
+#define CROLL__SEARCH_PREFETCH (CROLL_CACHE_LINE / sizeof(croll_u64))
+
+// In-order walk of the implicit tree hands out the sorted keys
+static void croll__searchFill(croll_SearchArray *sa, const croll_u64 *sorted, size_t *pos, size_t k) {
+    if(k > sa->len) return;
+    croll__searchFill(sa, sorted, pos, 2 * k);
+    sa->keys[k] = sorted[*pos];
+    sa->rank[k] = (*pos)++;
+    croll__searchFill(sa, sorted, pos, 2 * k + 1);
+}
+
+// Undo the trailing right turns taken after the last left one, 0 means every key was smaller
+static __CROLL_INLINE_ATTR size_t croll__searchFinish(size_t k) {
+    return k >> (croll__ctz64(~(croll_u64)k) + 1);
+}
+
+static __CROLL_INLINE_ATTR size_t croll__searchDescend(const croll_SearchArray *sa, croll_u64 key, bool upper) {
+    const croll_u64 *b = sa->keys;
+    size_t k = 1;
+    while(k <= sa->len) {
+        CROLL__PREFETCH(b + k * CROLL__SEARCH_PREFETCH);
+        k = 2 * k + (upper ? b[k] <= key : b[k] < key);
+    }
+    return croll__searchFinish(k);
+}
+
+__STATIC_FUNCTION croll_SearchArray croll_searchNew(const croll_u64 *sorted, size_t len) {
+    croll_SearchArray sa = {0};
+    size_t bytes = ((len + 1) * sizeof(croll_u64) + CROLL_CACHE_LINE - 1) & ~(size_t)(CROLL_CACHE_LINE - 1);
+    sa.keys = aligned_alloc(CROLL_CACHE_LINE, bytes);
+    croll_checkNullPtr(sa.keys) return (croll_SearchArray){0};
+    sa.rank = malloc((len + 1) * sizeof(size_t));
+    if(sa.rank == NULL) {
+        free(sa.keys);
+        return (croll_SearchArray){0};
+    }
+
+    sa.len = len;
+    sa.keys[0] = 0;
+    sa.rank[0] = len;
+    size_t pos = 0;
+    croll__searchFill(&sa, sorted, &pos, 1);
+    return sa;
+}
+
+__STATIC_FUNCTION size_t croll_searchLowerBound(const croll_SearchArray *sa, croll_u64 key) {
+    size_t k = croll__searchDescend(sa, key, false);
+    return k ? sa->rank[k] : sa->len;
+}
+
+__STATIC_FUNCTION size_t croll_searchUpperBound(const croll_SearchArray *sa, croll_u64 key) {
+    size_t k = croll__searchDescend(sa, key, true);
+    return k ? sa->rank[k] : sa->len;
+}
+
+__STATIC_FUNCTION bool croll_searchContains(const croll_SearchArray *sa, croll_u64 key) {
+    size_t k = croll__searchDescend(sa, key, false);
+    return k && sa->keys[k] == key;
+}
+
+__STATIC_FUNCTION void croll_searchLowerBoundBatch(const croll_SearchArray *sa, const croll_u64 *keys, size_t count, size_t *out) {
+    const croll_u64 *b = sa->keys;
+    size_t n = sa->len;
+    size_t levels = n ? croll__log2(n) + 1 : 0;
+
+    size_t i = 0;
+    for(; i + CROLL__SEARCH_BATCH <= count; i += CROLL__SEARCH_BATCH) {
+        size_t k[CROLL__SEARCH_BATCH];
+        for(size_t j = 0; j < CROLL__SEARCH_BATCH; j++) k[j] = 1;
+
+        // Every search takes the same number of steps, finished ones park on the dummy b[0]
+        for(size_t l = 0; l < levels; l++) {
+            for(size_t j = 0; j < CROLL__SEARCH_BATCH; j++) {
+                size_t cur = k[j];
+                size_t node = cur <= n ? cur : 0;
+                CROLL__PREFETCH(b + node * CROLL__SEARCH_PREFETCH);
+                size_t next = 2 * cur + (b[node] < keys[i + j]);
+                k[j] = cur <= n ? next : cur;
+            }
+        }
+
+        for(size_t j = 0; j < CROLL__SEARCH_BATCH; j++) {
+            size_t node = croll__searchFinish(k[j]);
+            out[i + j] = node ? sa->rank[node] : n;
+        }
+    }
+
+    for(; i < count; i++)
+        out[i] = croll_searchLowerBound(sa, keys[i]);
+}
+
+__STATIC_FUNCTION void croll_searchFree(croll_SearchArray *sa) {
+    free(sa->keys);
+    free(sa->rank);
+    *sa = (croll_SearchArray){0};
+}
+
+// B+tree
+
+#define CROLL__BTREE_MAX_KEYS 15
+#define CROLL__BTREE_POOL_NODES 256
+#define CROLL__BTREE_ARENA_SIZE (64 * 1024)
+
+// Keys are u64, or pointers to croll_StrView copies in string trees.
+// Inner nodes route keys >= keys[i] to children[i + 1].
+struct croll__BTreeNode {
+    croll_u32 len;
+    croll_u32 leaf;
+    croll_u64 keys[CROLL__BTREE_MAX_KEYS];
+    union {
+        void *values[CROLL__BTREE_MAX_KEYS];
+        struct croll__BTreeNode *children[CROLL__BTREE_MAX_KEYS + 1];
+    };
+    struct croll__BTreeNode *next; // leaves only
+};
+
+static __CROLL_INLINE_ATTR int croll__btreeCmp(const croll_BTree *tree, croll_u64 a, croll_u64 b) {
+    if(tree->str_keys == NULL) return (a > b) - (a < b);
+    const croll_StrView *x = (const croll_StrView *)(uintptr_t)a;
+    const croll_StrView *y = (const croll_StrView *)(uintptr_t)b;
+    size_t n = x->len < y->len ? x->len : y->len;
+    int c = n ? memcmp(x->data, y->data, n) : 0;
+    if(c != 0) return c;
+    return (x->len > y->len) - (x->len < y->len);
+}
+
+// Number of keys in the node that are < key, or <= key when inclusive
+static __CROLL_INLINE_ATTR size_t croll__btreeRank(const croll_BTree *tree, const struct croll__BTreeNode *node, croll_u64 key, bool inclusive) {
+    if(tree->str_keys == NULL) {
+        // Branchless count over the whole node, compiles to SIMD compares
+        size_t r = 0;
+        for(size_t i = 0; i < node->len; i++)
+            r += inclusive ? node->keys[i] <= key : node->keys[i] < key;
+        return r;
+    }
+
+    size_t lo = 0, hi = node->len;
+    while(lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int c = croll__btreeCmp(tree, node->keys[mid], key);
+        if(c < 0 || (inclusive && c == 0)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static struct croll__BTreeNode *croll__btreeNode(croll_BTree *tree, bool leaf) {
+    struct croll__BTreeNode *node = croll_poolAlloc(tree->nodes);
+    croll_checkNullPtr(node) return NULL;
+    node->len = 0;
+    node->leaf = leaf;
+    node->next = NULL;
+    return node;
+}
+
+static croll_u64 croll__btreeCopyKey(croll_BTree *tree, croll_StrView key) {
+    croll_StrView *copy = croll_bumpAllocOrExpand(tree->str_keys, sizeof(croll_StrView) + key.len + 1);
+    croll_checkNullPtr(copy) return 0;
+    char *data = (char *)(copy + 1);
+    if(key.len) memcpy(data, key.data, key.len);
+    data[key.len] = '\0';
+    *copy = (croll_StrView){data, key.len};
+    return (croll_u64)(uintptr_t)copy;
+}
+
+// Splits the full child i of parent, which must have room for one more key
+static bool croll__btreeSplit(croll_BTree *tree, struct croll__BTreeNode *parent, size_t i) {
+    struct croll__BTreeNode *child = parent->children[i];
+    struct croll__BTreeNode *right = croll__btreeNode(tree, child->leaf);
+    croll_checkNullPtr(right) return false;
+
+    size_t mid = CROLL__BTREE_MAX_KEYS / 2;
+    croll_u64 separator;
+    if(child->leaf) {
+        // The separator is copied up, the right leaf keeps it
+        right->len = child->len - mid;
+        memcpy(right->keys, child->keys + mid, right->len * sizeof(croll_u64));
+        memcpy(right->values, child->values + mid, right->len * sizeof(void *));
+        right->next = child->next;
+        child->next = right;
+        separator = right->keys[0];
+    } else {
+        // The separator moves up
+        right->len = child->len - mid - 1;
+        memcpy(right->keys, child->keys + mid + 1, right->len * sizeof(croll_u64));
+        memcpy(right->children, child->children + mid + 1, (right->len + 1) * sizeof(void *));
+        separator = child->keys[mid];
+    }
+    child->len = mid;
+
+    memmove(parent->keys + i + 1, parent->keys + i, (parent->len - i) * sizeof(croll_u64));
+    memmove(parent->children + i + 2, parent->children + i + 1, (parent->len - i) * sizeof(void *));
+    parent->keys[i] = separator;
+    parent->children[i + 1] = right;
+    parent->len++;
+    return true;
+}
+
+// probe is the key to compare with; str is the key to copy in for string trees
+static bool croll__btreeSet(croll_BTree *tree, croll_u64 probe, const croll_StrView *str, void *value) {
+    if(tree->root == NULL) {
+        tree->root = croll__btreeNode(tree, true);
+        croll_checkNullPtr(tree->root) return false;
+        tree->height = 1;
+    }
+
+    // Split full nodes on the way down so a split never has to walk back up
+    if(tree->root->len == CROLL__BTREE_MAX_KEYS) {
+        struct croll__BTreeNode *root = croll__btreeNode(tree, false);
+        croll_checkNullPtr(root) return false;
+        root->children[0] = tree->root;
+        if(!croll__btreeSplit(tree, root, 0)) {
+            croll_poolFree(tree->nodes, root);
+            return false;
+        }
+        tree->root = root;
+        tree->height++;
+    }
+
+    struct croll__BTreeNode *node = tree->root;
+    while(!node->leaf) {
+        size_t i = croll__btreeRank(tree, node, probe, true);
+        if(node->children[i]->len == CROLL__BTREE_MAX_KEYS) {
+            if(!croll__btreeSplit(tree, node, i)) return false;
+            if(croll__btreeCmp(tree, probe, node->keys[i]) >= 0) i++;
+        }
+        node = node->children[i];
+    }
+
+    size_t pos = croll__btreeRank(tree, node, probe, false);
+    if(pos < node->len && croll__btreeCmp(tree, node->keys[pos], probe) == 0) {
+        node->values[pos] = value;
+        return true;
+    }
+
+    croll_u64 key = probe;
+    if(str != NULL) {
+        key = croll__btreeCopyKey(tree, *str);
+        if(key == 0) return false;
+    }
+
+    memmove(node->keys + pos + 1, node->keys + pos, (node->len - pos) * sizeof(croll_u64));
+    memmove(node->values + pos + 1, node->values + pos, (node->len - pos) * sizeof(void *));
+    node->keys[pos] = key;
+    node->values[pos] = value;
+    node->len++;
+    tree->len++;
+    return true;
+}
+
+// Leaf and slot of the first key >= probe
+static croll_BTreeIter croll__btreeSeek(const croll_BTree *tree, croll_u64 probe) {
+    croll_BTreeIter it = {._str = tree->str_keys != NULL};
+    struct croll__BTreeNode *node = tree->root;
+    if(node == NULL) return it;
+    while(!node->leaf)
+        node = node->children[croll__btreeRank(tree, node, probe, true)];
+    it._leaf = node;
+    it._i = croll__btreeRank(tree, node, probe, false);
+    return it;
+}
+
+static void *croll__btreeGet(const croll_BTree *tree, croll_u64 probe) {
+    croll_BTreeIter it = croll__btreeSeek(tree, probe);
+    if(it._leaf == NULL || it._i >= it._leaf->len) return NULL;
+    if(croll__btreeCmp(tree, it._leaf->keys[it._i], probe) != 0) return NULL;
+    return it._leaf->values[it._i];
+}
+
+static bool croll__btreeBulkLoad(croll_BTree *tree, const croll_u64 *keys, const croll_StrView *strs, void *const *values, size_t len) {
+    croll_ASSERT(tree->root == NULL, "Bulk load into a non-empty tree at file: "__FILE__);
+    if(len == 0) return true;
+
+    // Build full leaves, then each inner level from the one below
+    croll_daDecl(struct croll__BTreeNode *, ) level = {0};
+    croll_daDecl(croll_u64, ) mins = {0};
+    struct croll__BTreeNode *prev = NULL;
+    for(size_t i = 0; i < len; i += CROLL__BTREE_MAX_KEYS) {
+        struct croll__BTreeNode *leaf = croll__btreeNode(tree, true);
+        croll_checkNullPtr(leaf) goto fail;
+        size_t n = len - i < CROLL__BTREE_MAX_KEYS ? len - i : CROLL__BTREE_MAX_KEYS;
+        for(size_t j = 0; j < n; j++) {
+            croll_u64 key = keys ? keys[i + j] : croll__btreeCopyKey(tree, strs[i + j]);
+            if(key == 0 && keys == NULL) goto fail;
+            leaf->keys[j] = key;
+            leaf->values[j] = values ? values[i + j] : NULL;
+        }
+        leaf->len = (croll_u32)n;
+        if(prev) prev->next = leaf;
+        prev = leaf;
+        croll_daAppend(&level, leaf);
+        croll_daAppend(&mins, leaf->keys[0]);
+        tree->len += n;
+    }
+    tree->height = 1;
+
+    while(level.len > 1) {
+        size_t count = level.len, out = 0;
+        for(size_t i = 0; i < count;) {
+            size_t n = count - i < CROLL__BTREE_MAX_KEYS + 1 ? count - i : CROLL__BTREE_MAX_KEYS + 1;
+            // Never leave a lone child for the last node
+            if(count - i - n == 1) n--;
+            struct croll__BTreeNode *inner = croll__btreeNode(tree, false);
+            croll_checkNullPtr(inner) goto fail;
+            croll_u64 min = mins.data[i];
+            for(size_t j = 0; j < n; j++) {
+                inner->children[j] = level.data[i + j];
+                if(j > 0) inner->keys[j - 1] = mins.data[i + j];
+            }
+            inner->len = (croll_u32)(n - 1);
+            level.data[out] = inner;
+            mins.data[out] = min;
+            out++;
+            i += n;
+        }
+        level.len = out;
+        mins.len = out;
+        tree->height++;
+    }
+
+    tree->root = level.data[0];
+    croll_daFree(&level);
+    croll_daFree(&mins);
+    return true;
+
+fail:
+    // Nodes stay in the pool until the tree is destroyed
+    tree->len = 0;
+    tree->height = 0;
+    croll_daFree(&level);
+    croll_daFree(&mins);
+    return false;
+}
+
+static croll_BTree *croll__btreeNew(bool str_keys) {
+    croll_BTree *tree = malloc(sizeof(croll_BTree));
+    croll_checkNullPtr(tree) return NULL;
+    *tree = (croll_BTree){0};
+
+    tree->nodes = croll_poolNew(CROLL__BTREE_POOL_NODES, sizeof(struct croll__BTreeNode));
+    croll_checkNullPtr(tree->nodes) {
+        free(tree);
+        return NULL;
+    }
+    if(str_keys) {
+        tree->str_keys = croll_bumpNew(CROLL__BTREE_ARENA_SIZE);
+        croll_checkNullPtr(tree->str_keys) {
+            croll_poolDestroy(tree->nodes);
+            free(tree);
+            return NULL;
+        }
+    }
+    return tree;
+}
+
+__STATIC_FUNCTION croll_BTree *croll_btreeNew(void) { return croll__btreeNew(false); }
+__STATIC_FUNCTION croll_BTree *croll_btreeNewStr(void) { return croll__btreeNew(true); }
+
+__STATIC_FUNCTION bool croll_btreeSet(croll_BTree *tree, croll_u64 key, void *value) {
+    croll_ASSERT(tree->str_keys == NULL, "u64 key on a string tree at file: "__FILE__);
+    return croll__btreeSet(tree, key, NULL, value);
+}
+
+__STATIC_FUNCTION bool croll_btreeSetStr(croll_BTree *tree, croll_StrView key, void *value) {
+    croll_ASSERT(tree->str_keys != NULL, "String key on a u64 tree at file: "__FILE__);
+    return croll__btreeSet(tree, (croll_u64)(uintptr_t)&key, &key, value);
+}
+
+__STATIC_FUNCTION void *croll_btreeGet(const croll_BTree *tree, croll_u64 key) {
+    croll_ASSERT(tree->str_keys == NULL, "u64 key on a string tree at file: "__FILE__);
+    return croll__btreeGet(tree, key);
+}
+
+__STATIC_FUNCTION void *croll_btreeGetStr(const croll_BTree *tree, croll_StrView key) {
+    croll_ASSERT(tree->str_keys != NULL, "String key on a u64 tree at file: "__FILE__);
+    return croll__btreeGet(tree, (croll_u64)(uintptr_t)&key);
+}
+
+__STATIC_FUNCTION bool croll_btreeBulkLoad(croll_BTree *tree, const croll_u64 *keys, void *const *values, size_t len) {
+    croll_ASSERT(tree->str_keys == NULL, "u64 key on a string tree at file: "__FILE__);
+    return croll__btreeBulkLoad(tree, keys, NULL, values, len);
+}
+
+__STATIC_FUNCTION bool croll_btreeBulkLoadStr(croll_BTree *tree, const croll_StrView *keys, void *const *values, size_t len) {
+    croll_ASSERT(tree->str_keys != NULL, "String key on a u64 tree at file: "__FILE__);
+    return croll__btreeBulkLoad(tree, NULL, keys, values, len);
+}
+
+__STATIC_FUNCTION croll_BTreeIter croll_btreeFirst(const croll_BTree *tree) {
+    croll_BTreeIter it = {._str = tree->str_keys != NULL};
+    struct croll__BTreeNode *node = tree->root;
+    if(node == NULL) return it;
+    while(!node->leaf) node = node->children[0];
+    it._leaf = node;
+    return it;
+}
+
+__STATIC_FUNCTION croll_BTreeIter croll_btreeSeek(const croll_BTree *tree, croll_u64 key) {
+    croll_ASSERT(tree->str_keys == NULL, "u64 key on a string tree at file: "__FILE__);
+    return croll__btreeSeek(tree, key);
+}
+
+__STATIC_FUNCTION croll_BTreeIter croll_btreeSeekStr(const croll_BTree *tree, croll_StrView key) {
+    croll_ASSERT(tree->str_keys != NULL, "String key on a u64 tree at file: "__FILE__);
+    return croll__btreeSeek(tree, (croll_u64)(uintptr_t)&key);
+}
+
+__STATIC_FUNCTION bool croll_btreeNext(croll_BTreeIter *it) {
+    while(it->_leaf != NULL && it->_i >= it->_leaf->len) {
+        it->_leaf = it->_leaf->next;
+        it->_i = 0;
+    }
+    if(it->_leaf == NULL) return false;
+
+    it->key = it->_leaf->keys[it->_i];
+    if(it->_str) it->str = *(const croll_StrView *)(uintptr_t)it->key;
+    it->value = it->_leaf->values[it->_i];
+    it->_i++;
+    return true;
+}
+
+__STATIC_FUNCTION void croll_btreeDestroy(croll_BTree *tree) {
+    croll_checkNullPtr(tree) return;
+    croll_poolDestroy(tree->nodes);
+    if(tree->str_keys) croll_bumpDestroy(tree->str_keys);
+    free(tree);
+}
+
+// adaptive radix tree
+
+#define CROLL__ART_PREFIX 8
+#define CROLL__ART_POOL_NODES 64
+#define CROLL__ART_ARENA_SIZE (64 * 1024)
+
+enum { CROLL__ART4, CROLL__ART16, CROLL__ART48, CROLL__ART256 };
+
+// Children are inner nodes or leaves tagged with the low bit.
+// `leaf` holds the key that ends exactly at this node, if any.
+struct croll__ArtNode {
+    croll_u8 type;
+    croll_u16 count;
+    croll_u32 prefix_len;
+    croll_u8 prefix[CROLL__ART_PREFIX];
+    struct croll__ArtLeaf *leaf;
+};
+
+struct croll__ArtNode4 { struct croll__ArtNode n; croll_u8 keys[4]; void *children[4]; };
+struct croll__ArtNode16 { struct croll__ArtNode n; croll_u8 keys[16]; void *children[16]; };
+struct croll__ArtNode48 { struct croll__ArtNode n; croll_u8 index[256]; void *children[48]; }; // index is slot + 1
+struct croll__ArtNode256 { struct croll__ArtNode n; void *children[256]; };
+
+struct croll__ArtLeaf {
+    void *value;
+    size_t len;
+    char key[];
+};
+
+static const size_t croll__artSizes[4] = {
+    sizeof(struct croll__ArtNode4), sizeof(struct croll__ArtNode16),
+    sizeof(struct croll__ArtNode48), sizeof(struct croll__ArtNode256),
+};
+
+#define CROLL__ART_IS_LEAF(p) ((uintptr_t)(p) & 1)
+#define CROLL__ART_LEAF(p) ((struct croll__ArtLeaf *)((uintptr_t)(p) & ~(uintptr_t)1))
+#define CROLL__ART_TAG(l) ((void *)((uintptr_t)(l) | 1))
+
+static __CROLL_INLINE_ATTR bool croll__artLeafIs(const struct croll__ArtLeaf *leaf, croll_StrView key) {
+    return leaf->len == key.len && (key.len == 0 || memcmp(leaf->key, key.data, key.len) == 0);
+}
+
+static struct croll__ArtNode *croll__artAlloc(croll_Art *art, int type) {
+    struct croll__ArtNode *n = croll_poolAlloc(art->pools[type]);
+    croll_checkNullPtr(n) return NULL;
+    memset(n, 0, croll__artSizes[type]);
+    n->type = (croll_u8)type;
+    art->_nodes[type]++;
+    return n;
+}
+
+static void croll__artRelease(croll_Art *art, struct croll__ArtNode *n) {
+    art->_nodes[n->type]--;
+    croll_poolFree(art->pools[n->type], n);
+}
+
+// Not counted until croll__artLinked, so a failed insert leaves len and stats alone
+static struct croll__ArtLeaf *croll__artLeaf(croll_Art *art, croll_StrView key, void *value) {
+    struct croll__ArtLeaf *leaf = croll_bumpAllocOrExpand(art->leaves, sizeof(struct croll__ArtLeaf) + key.len);
+    croll_checkNullPtr(leaf) return NULL;
+    leaf->value = value;
+    leaf->len = key.len;
+    if(key.len) memcpy(leaf->key, key.data, key.len);
+    return leaf;
+}
+
+// Counts a leaf once it is reachable from the tree
+static void croll__artLinked(croll_Art *art, const struct croll__ArtLeaf *leaf) {
+    art->_leaf_bytes += sizeof(struct croll__ArtLeaf) + leaf->len;
+    art->len++;
+}
+
+static void **croll__artFind(struct croll__ArtNode *n, croll_u8 byte) {
+    switch(n->type) {
+        case CROLL__ART4: {
+            struct croll__ArtNode4 *n4 = (struct croll__ArtNode4 *)n;
+            for(size_t i = 0; i < n->count; i++)
+                if(n4->keys[i] == byte) return &n4->children[i];
+            return NULL;
+        }
+        case CROLL__ART16: {
+            struct croll__ArtNode16 *n16 = (struct croll__ArtNode16 *)n;
+#if defined(CROLL__X86_SIMD) && defined(__SSE2__)
+            __m128i eq = _mm_cmpeq_epi8(_mm_set1_epi8((char)byte), _mm_loadu_si128((const __m128i *)n16->keys));
+            unsigned mask = (unsigned)_mm_movemask_epi8(eq) & ((1u << n->count) - 1);
+            return mask ? &n16->children[croll__ctz64(mask)] : NULL;
+#else
+            for(size_t i = 0; i < n->count; i++)
+                if(n16->keys[i] == byte) return &n16->children[i];
+            return NULL;
+#endif
+        }
+        case CROLL__ART48: {
+            struct croll__ArtNode48 *n48 = (struct croll__ArtNode48 *)n;
+            return n48->index[byte] ? &n48->children[n48->index[byte] - 1] : NULL;
+        }
+        default: {
+            struct croll__ArtNode256 *n256 = (struct croll__ArtNode256 *)n;
+            return n256->children[byte] ? &n256->children[byte] : NULL;
+        }
+    }
+}
+
+// Adds a child to the node at *ref, growing it into the next variant when full
+static bool croll__artAdd(croll_Art *art, void **ref, croll_u8 byte, void *child) {
+    struct croll__ArtNode *n = *ref;
+    switch(n->type) {
+        case CROLL__ART4:
+        case CROLL__ART16: {
+            // Node4 and Node16 keep keys sorted for ordered iteration
+            croll_u8 *keys = n->type == CROLL__ART4 ? ((struct croll__ArtNode4 *)n)->keys : ((struct croll__ArtNode16 *)n)->keys;
+            void **children = n->type == CROLL__ART4 ? ((struct croll__ArtNode4 *)n)->children : ((struct croll__ArtNode16 *)n)->children;
+            size_t cap = n->type == CROLL__ART4 ? 4 : 16;
+            if(n->count < cap) {
+                size_t pos = 0;
+                while(pos < n->count && keys[pos] < byte) pos++;
+                memmove(keys + pos + 1, keys + pos, n->count - pos);
+                memmove(children + pos + 1, children + pos, (n->count - pos) * sizeof(void *));
+                keys[pos] = byte;
+                children[pos] = child;
+                n->count++;
+                return true;
+            }
+
+            struct croll__ArtNode *grown = croll__artAlloc(art, n->type + 1);
+            croll_checkNullPtr(grown) return false;
+            memcpy(grown, n, sizeof(struct croll__ArtNode));
+            grown->type = (croll_u8)(n->type + 1);
+            if(n->type == CROLL__ART4) {
+                struct croll__ArtNode16 *n16 = (struct croll__ArtNode16 *)grown;
+                memcpy(n16->keys, keys, cap);
+                memcpy(n16->children, children, cap * sizeof(void *));
+            } else {
+                struct croll__ArtNode48 *n48 = (struct croll__ArtNode48 *)grown;
+                for(size_t i = 0; i < cap; i++) {
+                    n48->index[keys[i]] = (croll_u8)(i + 1);
+                    n48->children[i] = children[i];
+                }
+            }
+            croll__artRelease(art, n);
+            *ref = grown;
+            return croll__artAdd(art, ref, byte, child);
+        }
+        case CROLL__ART48: {
+            struct croll__ArtNode48 *n48 = (struct croll__ArtNode48 *)n;
+            if(n->count < 48) {
+                // Nothing is ever removed, so slots fill up in order
+                n48->children[n->count] = child;
+                n48->index[byte] = (croll_u8)(n->count + 1);
+                n->count++;
+                return true;
+            }
+
+            struct croll__ArtNode256 *n256 = (struct croll__ArtNode256 *)croll__artAlloc(art, CROLL__ART256);
+            croll_checkNullPtr(n256) return false;
+            memcpy(&n256->n, n, sizeof(struct croll__ArtNode));
+            n256->n.type = CROLL__ART256;
+            for(size_t b = 0; b < 256; b++)
+                if(n48->index[b]) n256->children[b] = n48->children[n48->index[b] - 1];
+            croll__artRelease(art, n);
+            *ref = n256;
+            return croll__artAdd(art, ref, byte, child);
+        }
+        default: {
+            ((struct croll__ArtNode256 *)n)->children[byte] = child;
+            n->count++;
+            return true;
+        }
+    }
+}
+
+// Smallest key below p, used to recover path bytes past the stored prefix
+static struct croll__ArtLeaf *croll__artMinLeaf(void *p) {
+    for(;;) {
+        if(CROLL__ART_IS_LEAF(p)) return CROLL__ART_LEAF(p);
+        struct croll__ArtNode *n = p;
+        if(n->leaf) return n->leaf;
+        switch(n->type) {
+            case CROLL__ART4: p = ((struct croll__ArtNode4 *)n)->children[0]; break;
+            case CROLL__ART16: p = ((struct croll__ArtNode16 *)n)->children[0]; break;
+            case CROLL__ART48: {
+                struct croll__ArtNode48 *n48 = (struct croll__ArtNode48 *)n;
+                size_t b = 0;
+                while(!n48->index[b]) b++;
+                p = n48->children[n48->index[b] - 1];
+                break;
+            }
+            default: {
+                struct croll__ArtNode256 *n256 = (struct croll__ArtNode256 *)n;
+                size_t b = 0;
+                while(!n256->children[b]) b++;
+                p = n256->children[b];
+                break;
+            }
+        }
+    }
+}
+
+// Number of prefix bytes of n that match key from depth
+static size_t croll__artMismatch(struct croll__ArtNode *n, croll_StrView key, size_t depth) {
+    size_t max = key.len - depth < n->prefix_len ? key.len - depth : n->prefix_len;
+    size_t stored = max < CROLL__ART_PREFIX ? max : CROLL__ART_PREFIX;
+    size_t i = 0;
+    for(; i < stored; i++)
+        if(n->prefix[i] != (croll_u8)key.data[depth + i]) return i;
+    if(i < max) {
+        struct croll__ArtLeaf *leaf = croll__artMinLeaf(n);
+        for(; i < max; i++)
+            if(leaf->key[depth + i] != key.data[depth + i]) return i;
+    }
+    return i;
+}
+
+// Hangs a leaf off a fresh node at depth, in the node's own slot if the key ends there
+static bool croll__artPlace(croll_Art *art, void **ref, struct croll__ArtLeaf *leaf, size_t depth) {
+    if(leaf->len == depth) {
+        ((struct croll__ArtNode *)*ref)->leaf = leaf;
+        return true;
+    }
+    return croll__artAdd(art, ref, (croll_u8)leaf->key[depth], CROLL__ART_TAG(leaf));
+}
+
+__STATIC_FUNCTION croll_Art *croll_artNew(void) {
+    croll_Art *art = malloc(sizeof(croll_Art));
+    croll_checkNullPtr(art) return NULL;
+    *art = (croll_Art){0};
+
+    for(size_t t = 0; t < 4; t++) {
+        art->pools[t] = croll_poolNew(CROLL__ART_POOL_NODES, croll__artSizes[t]);
+        croll_checkNullPtr(art->pools[t]) {
+            croll_artDestroy(art);
+            return NULL;
+        }
+    }
+    art->leaves = croll_bumpNew(CROLL__ART_ARENA_SIZE);
+    croll_checkNullPtr(art->leaves) {
+        croll_artDestroy(art);
+        return NULL;
+    }
+    return art;
+}
+
+__STATIC_FUNCTION bool croll_artSet(croll_Art *art, croll_StrView key, void *value) {
+    void **ref = &art->root;
+    size_t depth = 0;
+
+    for(;;) {
+        void *p = *ref;
+        if(p == NULL) {
+            struct croll__ArtLeaf *leaf = croll__artLeaf(art, key, value);
+            croll_checkNullPtr(leaf) return false;
+            *ref = CROLL__ART_TAG(leaf);
+            croll__artLinked(art, leaf);
+            return true;
+        }
+
+        if(CROLL__ART_IS_LEAF(p)) {
+            struct croll__ArtLeaf *old = CROLL__ART_LEAF(p);
+            if(croll__artLeafIs(old, key)) {
+                old->value = value;
+                return true;
+            }
+
+            // Two keys now share this spot, put a Node4 over their common bytes
+            size_t max = (old->len < key.len ? old->len : key.len) - depth, lcp = 0;
+            while(lcp < max && old->key[depth + lcp] == key.data[depth + lcp]) lcp++;
+
+            void *split = croll__artAlloc(art, CROLL__ART4);
+            croll_checkNullPtr(split) return false;
+            struct croll__ArtLeaf *leaf = croll__artLeaf(art, key, value);
+            croll_checkNullPtr(leaf) {
+                croll__artRelease(art, split);
+                return false;
+            }
+            struct croll__ArtNode *n = split;
+            n->prefix_len = (croll_u32)lcp;
+            memcpy(n->prefix, key.data + depth, lcp < CROLL__ART_PREFIX ? lcp : CROLL__ART_PREFIX);
+            croll__artPlace(art, &split, old, depth + lcp);
+            croll__artPlace(art, &split, leaf, depth + lcp);
+            *ref = split;
+            croll__artLinked(art, leaf);
+            return true;
+        }
+
+        struct croll__ArtNode *n = p;
+        if(n->prefix_len) {
+            size_t mismatch = croll__artMismatch(n, key, depth);
+            if(mismatch < n->prefix_len) {
+                // The key leaves the compressed path early, split the path at the mismatch
+                void *split = croll__artAlloc(art, CROLL__ART4);
+                croll_checkNullPtr(split) return false;
+                struct croll__ArtLeaf *leaf = croll__artLeaf(art, key, value);
+                croll_checkNullPtr(leaf) {
+                    croll__artRelease(art, split);
+                    return false;
+                }
+
+                const croll_u8 *full = n->prefix_len <= CROLL__ART_PREFIX ? n->prefix : (const croll_u8 *)croll__artMinLeaf(n)->key + depth;
+                struct croll__ArtNode *s = split;
+                s->prefix_len = (croll_u32)mismatch;
+                memcpy(s->prefix, full, mismatch < CROLL__ART_PREFIX ? mismatch : CROLL__ART_PREFIX);
+                croll_u8 byte = full[mismatch];
+                n->prefix_len -= (croll_u32)(mismatch + 1);
+                memmove(n->prefix, full + mismatch + 1, n->prefix_len < CROLL__ART_PREFIX ? n->prefix_len : CROLL__ART_PREFIX);
+
+                croll__artAdd(art, &split, byte, n);
+                croll__artPlace(art, &split, leaf, depth + mismatch);
+                *ref = split;
+                croll__artLinked(art, leaf);
+                return true;
+            }
+            depth += n->prefix_len;
+        }
+
+        if(depth == key.len) {
+            if(n->leaf) {
+                n->leaf->value = value;
+                return true;
+            }
+            n->leaf = croll__artLeaf(art, key, value);
+            croll_checkNullPtr(n->leaf) return false;
+            croll__artLinked(art, n->leaf);
+            return true;
+        }
+
+        void **child = croll__artFind(n, (croll_u8)key.data[depth]);
+        if(child == NULL) {
+            struct croll__ArtLeaf *leaf = croll__artLeaf(art, key, value);
+            croll_checkNullPtr(leaf) return false;
+            if(!croll__artAdd(art, ref, (croll_u8)key.data[depth], CROLL__ART_TAG(leaf))) return false;
+            croll__artLinked(art, leaf);
+            return true;
+        }
+        ref = child;
+        depth++;
+    }
+}
 
-/**
- * @brief Destroys a hash table and frees all memory.
- *
- * @param ht Pointer to hash table.
- */
-__STATIC_FUNCTION void croll_htDestroy(croll_HashTable *ht);
+__STATIC_FUNCTION void *croll_artGet(const croll_Art *art, croll_StrView key) {
+    void *p = art->root;
+    size_t depth = 0;
 
-//======================================================================
-// Miscellaneous
-//======================================================================
-/**
- * @brief DJB2 string hash function.
- *
- * @param str Null-terminated string.
- * @return    Computed 32/64-bit hash.
- */
-__STATIC_FUNCTION size_t croll_hashDjb2(const char *str);
+    while(p != NULL) {
+        if(CROLL__ART_IS_LEAF(p)) {
+            struct croll__ArtLeaf *leaf = CROLL__ART_LEAF(p);
+            return croll__artLeafIs(leaf, key) ? leaf->value : NULL;
+        }
 
-#ifdef __cplusplus
+        struct croll__ArtNode *n = p;
+        if(n->prefix_len) {
+            // Only the stored bytes are checked, the final leaf compare catches the rest
+            if(key.len - depth < n->prefix_len) return NULL;
+            size_t stored = n->prefix_len < CROLL__ART_PREFIX ? n->prefix_len : CROLL__ART_PREFIX;
+            if(memcmp(n->prefix, key.data + depth, stored) != 0) return NULL;
+            depth += n->prefix_len;
+        }
+
+        if(depth == key.len)
+            return n->leaf && croll__artLeafIs(n->leaf, key) ? n->leaf->value : NULL;
+
+        void **child = croll__artFind(n, (croll_u8)key.data[depth]);
+        if(child == NULL) return NULL;
+        p = *child;
+        depth++;
+    }
+    return NULL;
 }
-#endif
 
-//======================================================================
-// Implementation
-//======================================================================
+static bool croll__artWalk(void *p, croll_ArtVisit fn, void *user, size_t *visited) {
+    if(CROLL__ART_IS_LEAF(p)) {
+        struct croll__ArtLeaf *leaf = CROLL__ART_LEAF(p);
+        (*visited)++;
+        return fn((croll_StrView){leaf->key, leaf->len}, leaf->value, user);
+    }
 
-#ifdef CROLL_IMPLEMENTATION
+    struct croll__ArtNode *n = p;
+    if(n->leaf && !croll__artWalk(CROLL__ART_TAG(n->leaf), fn, user, visited)) return false;
+    switch(n->type) {
+        case CROLL__ART4:
+            for(size_t i = 0; i < n->count; i++)
+                if(!croll__artWalk(((struct croll__ArtNode4 *)n)->children[i], fn, user, visited)) return false;
+            break;
+        case CROLL__ART16:
+            for(size_t i = 0; i < n->count; i++)
+                if(!croll__artWalk(((struct croll__ArtNode16 *)n)->children[i], fn, user, visited)) return false;
+            break;
+        case CROLL__ART48: {
+            struct croll__ArtNode48 *n48 = (struct croll__ArtNode48 *)n;
+            for(size_t b = 0; b < 256; b++)
+                if(n48->index[b] && !croll__artWalk(n48->children[n48->index[b] - 1], fn, user, visited)) return false;
+            break;
+        }
+        default: {
+            struct croll__ArtNode256 *n256 = (struct croll__ArtNode256 *)n;
+            for(size_t b = 0; b < 256; b++)
+                if(n256->children[b] && !croll__artWalk(n256->children[b], fn, user, visited)) return false;
+            break;
+        }
+    }
+    return true;
+}
 
-__STATIC_FUNCTION void croll_init() {
-    croll_STDIN = stdin;
-    croll_STDERR = stderr;
-    croll_STDOUT = stdout;
+__STATIC_FUNCTION size_t croll_artIterPrefix(const croll_Art *art, croll_StrView prefix, croll_ArtVisit fn, void *user) {
+    void *p = art->root;
+    size_t depth = 0, visited = 0;
+
+    while(p != NULL) {
+        if(!CROLL__ART_IS_LEAF(p)) {
+            struct croll__ArtNode *n = p;
+            if(depth + n->prefix_len < prefix.len) {
+                size_t stored = n->prefix_len < CROLL__ART_PREFIX ? n->prefix_len : CROLL__ART_PREFIX;
+                if(memcmp(n->prefix, prefix.data + depth, stored) != 0) return 0;
+                depth += n->prefix_len;
+                void **child = croll__artFind(n, (croll_u8)prefix.data[depth]);
+                if(child == NULL) return 0;
+                p = *child;
+                depth++;
+                continue;
+            }
+        }
+
+        // Every key below p shares its first bytes, so checking one settles the whole subtree
+        struct croll__ArtLeaf *leaf = croll__artMinLeaf(p);
+        if(leaf->len < prefix.len || (prefix.len && memcmp(leaf->key, prefix.data, prefix.len) != 0)) return 0;
+        croll__artWalk(p, fn, user, &visited);
+        return visited;
+    }
+    return 0;
 }
 
-// logging
+__STATIC_FUNCTION croll_ArtStats croll_artStats(const croll_Art *art) {
+    croll_ArtStats stats = {0};
+    for(size_t t = 0; t < 4; t++) {
+        stats.nodes[t] = art->_nodes[t];
+        stats.node_bytes[t] = art->_nodes[t] * croll__artSizes[t];
+    }
+    stats.leaves = art->len;
+    stats.leaf_bytes = art->_leaf_bytes;
+    return stats;
+}
 
-__STATIC_FUNCTION void croll_logInfo(const char *format, ...) {
-    fprintf(croll_STDOUT, "\033[94m[INFO]\033[0m ");
-    va_list args;
-    va_start(args, format);
-    vprintf(format, args);
-    va_end(args);
+__STATIC_FUNCTION void croll_artDestroy(croll_Art *art) {
+    croll_checkNullPtr(art) return;
+    for(size_t t = 0; t < 4; t++)
+        if(art->pools[t]) croll_poolDestroy(art->pools[t]);
+    if(art->leaves) croll_bumpDestroy(art->leaves);
+    free(art);
 }
 
-__STATIC_FUNCTION void croll_logWarn(const char *format, ...) {
-    fprintf(croll_STDERR, "\033[93m[WARN]\033[0m ");
-    va_list args;
-    va_start(args, format);
-    vfprintf(croll_STDERR, format, args);
-    va_end(args);
+// slot map
+
+#define CROLL__SLOT_NONE UINT32_MAX
+#define CROLL__SLOT_INDEX_MASK ((croll_u32)(((croll_u64)1 << CROLL__SLOT_INDEX_BITS) - 1))
+#define CROLL__SLOT_GEN_MASK ((croll_u32)(((croll_u64)1 << CROLL__SLOT_GEN_BITS) - 1))
+// Most slots a map can hold: every index the handle can encode, except the free-list sentinel
+#define CROLL__SLOT_CAPACITY ((size_t)CROLL__SLOT_INDEX_MASK < (size_t)CROLL__SLOT_NONE ? (size_t)CROLL__SLOT_INDEX_MASK + 1 : (size_t)CROLL__SLOT_NONE)
+
+static __CROLL_INLINE_ATTR croll_SlotHandle croll__slotHandle(croll_u32 index, croll_u32 gen) {
+    return ((croll_SlotHandle)gen << CROLL__SLOT_INDEX_BITS) | index;
 }
 
-__STATIC_FUNCTION void croll_logError(const char *format, ...) {
-    fprintf(croll_STDERR, "\033[91m[ERROR]\033[0m ");
-    va_list args;
-    va_start(args, format);
-    vfprintf(croll_STDERR, format, args);
-    va_end(args);
+// Slot of a live handle, or NULL
+static __CROLL_INLINE_ATTR croll__Slot *croll__slotLookup(const croll_SlotMap *sm, croll_SlotHandle h) {
+    croll_u32 index = (croll_u32)(h & CROLL__SLOT_INDEX_MASK);
+    croll_u32 gen = (croll_u32)(h >> CROLL__SLOT_INDEX_BITS);
+    if(gen == 0 || index >= sm->slots.len) return NULL;
+    croll__Slot *slot = &sm->slots.data[index];
+    if(slot->gen != gen || slot->index >= sm->len || sm->dense_slot.data[slot->index] != index) return NULL;
+    return slot;
 }
 
-// strings
+__STATIC_FUNCTION croll_SlotMap croll_slotmapNew(size_t elem_size) {
+    return (croll_SlotMap){.elem_size = elem_size, .free_head = CROLL__SLOT_NONE};
+}
 
-__STATIC_FUNCTION char *croll_textFmt(const char *format, ...) {
-    #ifndef CROLL_MAX_TEXTFMT_BUFFERS
-    #define CROLL_MAX_TEXTFMT_BUFFERS 4
-    #endif
+__STATIC_FUNCTION croll_SlotHandle croll_slotmapInsert(croll_SlotMap *sm, const void *elem) {
+    if(sm->free_head == CROLL__SLOT_NONE && sm->slots.len >= CROLL__SLOT_CAPACITY) return CROLL_SLOT_NULL;
+    if(sm->len == sm->cap) {
+        size_t cap = sm->cap ? sm->cap * 2 : croll_daInitCap;
+        croll_byte *data = realloc(sm->data, cap * sm->elem_size);
+        croll_checkNullPtr(data) return CROLL_SLOT_NULL;
+        sm->data = data;
+        sm->cap = cap;
+    }
 
-    #ifndef CROLL_TEXTFMT_BUFFER_SIZE
-    #define CROLL_TEXTFMT_BUFFER_SIZE 1024
-    #endif
+    croll_u32 index = sm->free_head;
+    if(index == CROLL__SLOT_NONE) {
+        index = (croll_u32)sm->slots.len;
+        croll_daAppend(&sm->slots, ((croll__Slot){.gen = 1}));
+    } else {
+        sm->free_head = sm->slots.data[index].index;
+    }
 
-    static char buffers[CROLL_MAX_TEXTFMT_BUFFERS][CROLL_TEXTFMT_BUFFER_SIZE] = {0};
-    static int index = 0;
-    index = (index + 1) % CROLL_MAX_TEXTFMT_BUFFERS;
-    
-    memset(buffers[index], 0, CROLL_TEXTFMT_BUFFER_SIZE);
+    croll__Slot *slot = &sm->slots.data[index];
+    slot->index = (croll_u32)sm->len;
+    croll_daAppend(&sm->dense_slot, index);
+    memcpy(sm->data + sm->len * sm->elem_size, elem, sm->elem_size);
+    sm->len++;
+    return croll__slotHandle(index, slot->gen);
+}
 
-    va_list args;
-    va_start(args, format);
-    int size = vsnprintf(buffers[index], CROLL_TEXTFMT_BUFFER_SIZE, format, args);
-    va_end(args);
+__STATIC_FUNCTION void *croll_slotmapGet(const croll_SlotMap *sm, croll_SlotHandle h) {
+    croll__Slot *slot = croll__slotLookup(sm, h);
+    return slot ? sm->data + slot->index * sm->elem_size : NULL;
+}
 
-    if(size >= CROLL_TEXTFMT_BUFFER_SIZE) {
-        sprintf(buffers[index] + CROLL_TEXTFMT_BUFFER_SIZE - 4, "...");
+__STATIC_FUNCTION bool croll_slotmapValid(const croll_SlotMap *sm, croll_SlotHandle h) {
+    return croll__slotLookup(sm, h) != NULL;
+}
+
+__STATIC_FUNCTION bool croll_slotmapRemove(croll_SlotMap *sm, croll_SlotHandle h) {
+    croll__Slot *slot = croll__slotLookup(sm, h);
+    croll_checkNullPtr(slot) return false;
+
+    // Swap-remove: the last object fills the hole and its slot is repointed
+    size_t hole = slot->index, last = sm->len - 1;
+    if(hole != last) {
+        memcpy(sm->data + hole * sm->elem_size, sm->data + last * sm->elem_size, sm->elem_size);
+        croll_u32 moved = sm->dense_slot.data[last];
+        sm->dense_slot.data[hole] = moved;
+        sm->slots.data[moved].index = (croll_u32)hole;
     }
+    sm->dense_slot.len--;
+    sm->len--;
+
+    // Bumping the generation invalidates every outstanding handle, 0 is skipped on wrap
+    croll_u32 index = (croll_u32)(h & CROLL__SLOT_INDEX_MASK);
+    slot->gen = (slot->gen + 1) & CROLL__SLOT_GEN_MASK;
+    if(slot->gen == 0) slot->gen = 1;
+    slot->index = sm->free_head;
+    sm->free_head = index;
+    return true;
+}
 
-    return buffers[index];
+__STATIC_FUNCTION croll_SlotHandle croll_slotmapHandleAt(const croll_SlotMap *sm, size_t i) {
+    croll_ASSERT(i < sm->len, "Slot map index out of range at file: "__FILE__);
+    croll_u32 index = sm->dense_slot.data[i];
+    return croll__slotHandle(index, sm->slots.data[index].gen);
 }
 
-__STATIC_FUNCTION char *croll_textSubString(const char *str, size_t start, size_t end) {
-    char *nstr = croll_textFmt("%.*s", (int)((end + 1) - start), str + start);
-    nstr[end + 1] = '\0';
-    return nstr;
+__STATIC_FUNCTION void croll_slotmapFree(croll_SlotMap *sm) {
+    free(sm->data);
+    croll_daFree(&sm->dense_slot);
+    croll_daFree(&sm->slots);
+    *sm = croll_slotmapNew(sm->elem_size);
 }
 
-// IO
+// packed array
 
-__STATIC_FUNCTION croll_StringBuilder croll_HgetLine() {
-    croll_StringBuilder sb = {0};
-    while (true) {
-        char c = fgetc(croll_STDIN);
-        if (c == EOF || c == '\n') break;
-        croll_daAppend(&sb, c);
+// Bytes of zeroed slack after packed bits, enough for one 32-byte vector load past the end
+#define CROLL__PACK_PADDING 32
+
+static __CROLL_INLINE_ATTR croll_u32 croll__packMask(size_t bits) {
+    return (croll_u32)(((croll_u64)1 << bits) - 1);
+}
+
+// Values packed from bit 0 of src; the byte view assumes a little-endian target
+static void croll__unpackBitsScalar(const croll_byte *src, size_t bits, size_t count, croll_u32 *out) {
+    croll_u32 mask = croll__packMask(bits);
+    for(size_t i = 0; i < count; i++) {
+        size_t bit = i * bits;
+        croll_u64 chunk;
+        memcpy(&chunk, src + (bit >> 3), sizeof(chunk));
+        out[i] = (croll_u32)(chunk >> (bit & 7)) & mask;
     }
-    croll_daAppend(&sb, '\0'); // ensures null termination
-    return sb;
 }
 
-__STATIC_FUNCTION bool croll_SgetLine(char *buffer, size_t buffer_size) {
-    croll_ASSERT(buffer != NULL, "Buffer must not be NULL at file: "__FILE__);
-    croll_ASSERT(buffer_size > 0, "Buffer size must be greater than 0 at file: "__FILE__);
-    size_t buffer_length = 1;
-    while (true) {
-        char c = fgetc(croll_STDIN);
-        if (c == EOF || c == '\n') break;
-        *buffer++ = c;
-        buffer_length++;
-        if (buffer_length >= buffer_size) {
-            *buffer = '\0';
-            return false;
-        }
+#ifdef CROLL__X86_SIMD
+// 8 values of `bits` bits always start on a byte boundary and fit one 32-byte window,
+// each lane pulls its two 32-bit neighbours out of the window and funnels them together
+CROLL__AVX2 void croll__unpackBitsAvx2(const croll_byte *src, size_t bits, size_t count, croll_u32 *out) {
+    croll_u32 lo_idx[8], shift[8];
+    for(size_t j = 0; j < 8; j++) {
+        lo_idx[j] = (croll_u32)((j * bits) >> 5);
+        shift[j] = (croll_u32)((j * bits) & 31);
     }
-    *buffer = '\0';
-    return true;
+    const __m256i lo_lane = croll__ld256(lo_idx);
+    const __m256i hi_lane = _mm256_add_epi32(lo_lane, _mm256_set1_epi32(1));
+    const __m256i right = croll__ld256(shift);
+    const __m256i left = _mm256_sub_epi32(_mm256_set1_epi32(32), right);
+    const __m256i mask = _mm256_set1_epi32((int)croll__packMask(bits));
+
+    size_t i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m256i window = croll__ld256(src + (i / 8) * bits);
+        __m256i lo = _mm256_srlv_epi32(_mm256_permutevar8x32_epi32(window, lo_lane), right);
+        __m256i hi = _mm256_sllv_epi32(_mm256_permutevar8x32_epi32(window, hi_lane), left);
+        croll__st256(out + i, _mm256_and_si256(_mm256_or_si256(lo, hi), mask));
+    }
+    croll__unpackBitsScalar(src + (i / 8) * bits, bits, count - i, out + i);
 }
 
-__STATIC_FUNCTION croll_StringBuilder croll_readEntireFile(const char *path) {
-    FILE *file = fopen(path, "r");
-    croll_checkNullPtr(file) return (croll_StringBuilder){0};
-    croll_StringBuilder sb = {0};
+static void croll__unpackBitsSse(const croll_byte *src, size_t bits, size_t count, croll_u32 *out) {
+    croll__unpackBitsScalar(src, bits, count, out);
+}
+#endif // CROLL__X86_SIMD
 
-    while (true) {
-        char c = fgetc(file);
-        if (c == EOF) break;
-        croll_sbAppend(&sb, c);
+// Shared by the packed array and the integer sequence block decoder
+__STATIC_FUNCTION void croll__unpackBits(const croll_byte *src, size_t bits, size_t count, croll_u32 *out) {
+    CROLL__SIMD_DISPATCH_VOID(croll__unpackBits, src, bits, count, out);
+}
+
+static void croll__packBits(croll_byte *dst, size_t bits, const croll_u32 *values, size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        size_t bit = i * bits;
+        croll_u64 chunk;
+        memcpy(&chunk, dst + (bit >> 3), sizeof(chunk));
+        chunk |= (croll_u64)(values[i] & croll__packMask(bits)) << (bit & 7);
+        memcpy(dst + (bit >> 3), &chunk, sizeof(chunk));
     }
-    croll_sbAppend(&sb, '\0'); // ensures null termination
-    fclose(file);
-    return sb;
 }
 
-// memory
+__STATIC_FUNCTION croll_PackedArray croll_packedNew(size_t len, croll_u32 bits) {
+    croll_ASSERT(bits >= 1 && bits <= 32, "Packed width must be 1..32 bits at file: "__FILE__);
+    croll_PackedArray pa = {0};
+    size_t nwords = (len * bits + 63) / 64 + CROLL__PACK_PADDING / sizeof(croll_u64);
+    pa.words = calloc(nwords, sizeof(croll_u64));
+    croll_checkNullPtr(pa.words) return (croll_PackedArray){0};
+    pa.len = len;
+    pa.bits = bits;
+    return pa;
+}
 
-__STATIC_FUNCTION croll_BumpAlloc *croll_bumpNew(size_t cap) {
-    croll_BumpAlloc *bump = malloc(sizeof(croll_BumpAlloc));
-    croll_checkNullPtr(bump) return NULL;
-    
-    bump->data = malloc(cap);
-    croll_checkNullPtr(bump->data) {
-        free(bump);
-        return NULL;
-    }
-    bump->_next = NULL;
-    bump->size = cap;
-    bump->offset = 0;
-    
-    return bump;
+__STATIC_FUNCTION void croll_packedAppend(croll_PackedArray *pa, croll_u32 value) {
+    croll_ASSERT(pa->bits == 0, "Append to a frozen packed array at file: "__FILE__);
+    croll_daAppend(&pa->staging, value);
 }
 
-__STATIC_FUNCTION __CROLL_INLINE_ATTR void *croll_bumpAlloc(croll_BumpAlloc *bump, size_t size) {
-    if(size == 0) return NULL;
-    if(size & 0b111) size = croll_ALLOC_ALIGN(size);
+__STATIC_FUNCTION bool croll_packedFreeze(croll_PackedArray *pa) {
+    croll_ASSERT(pa->bits == 0, "Packed array is already frozen at file: "__FILE__);
+    croll_u32 max = pa->staging.len ? croll_daMax(&pa->staging) : 0;
+    croll_PackedArray packed = croll_packedNew(pa->staging.len, max ? (croll_u32)croll__log2(max) + 1 : 1);
+    croll_checkNullPtr(packed.words) return false;
 
-    size_t cur_addr = (size_t)bump->data + bump->offset;
-    if(cur_addr + size > (size_t)bump->data + bump->size)
-        return NULL;
-    
-    bump->offset += size;
-    return (void *)cur_addr;
+    croll__packBits((croll_byte *)packed.words, packed.bits, pa->staging.data, pa->staging.len);
+    croll_daFree(&pa->staging);
+    *pa = packed;
+    return true;
 }
 
-__STATIC_FUNCTION __CROLL_INLINE_ATTR void *croll_bumpAllocOrExpand(croll_BumpAlloc *bump, size_t size) {
-    if(size == 0) return NULL;
-    if(size & 0b111) size = croll_ALLOC_ALIGN(size);
+__STATIC_FUNCTION __CROLL_INLINE_ATTR croll_u32 croll_packedGet(const croll_PackedArray *pa, size_t i) {
+    croll_ASSERT(i < pa->len, "Packed index out of range at file: "__FILE__);
+    size_t bit = i * pa->bits, w = bit >> 6, off = bit & 63;
+    // Two-word read without a branch, the padding word keeps words[w + 1] in bounds
+    croll_u64 v = (pa->words[w] >> off) | ((pa->words[w + 1] << 1) << (63 - off));
+    return (croll_u32)v & croll__packMask(pa->bits);
+}
 
-    size_t cur_addr = (size_t)bump->data + bump->offset;
-    if(cur_addr + size > (size_t)bump->data + bump->size) {
-        while(cur_addr + size > (size_t)bump->data + bump->size) {
-            if(bump->_next == NULL) {
-                bump->_next = croll_bumpNew(bump->size);
-                if(bump->_next == NULL) return NULL;
-            }
-            bump = bump->_next;
-            cur_addr = (size_t)bump->data + bump->offset;
-        }
+__STATIC_FUNCTION __CROLL_INLINE_ATTR void croll_packedSet(croll_PackedArray *pa, size_t i, croll_u32 value) {
+    croll_ASSERT(i < pa->len, "Packed index out of range at file: "__FILE__);
+    size_t bit = i * pa->bits, w = bit >> 6, off = bit & 63;
+    croll_u64 mask = croll__packMask(pa->bits), v = value & mask;
+    pa->words[w] = (pa->words[w] & ~(mask << off)) | (v << off);
+    if(off + pa->bits > 64) {
+        size_t spill = 64 - off;
+        pa->words[w + 1] = (pa->words[w + 1] & ~(mask >> spill)) | (v >> spill);
     }
+}
 
-    bump->offset += size;
-    return (void *)cur_addr;
-} 
-
-__STATIC_FUNCTION __CROLL_INLINE_ATTR void croll_bumpReset(croll_BumpAlloc *bump) {
-    bump->offset = 0;
-    while(bump->_next != NULL) {
-        bump = bump->_next;
-        bump->offset = 0;
+__STATIC_FUNCTION void croll_packedUnpack(const croll_PackedArray *pa, size_t start, size_t count, croll_u32 *out) {
+    croll_ASSERT(start + count <= pa->len, "Packed range out of range at file: "__FILE__);
+    // Scalar up to a multiple of 8, where groups of values start on byte boundaries
+    size_t head = 0;
+    while(head < count && (start + head) % 8 != 0) {
+        out[head] = croll_packedGet(pa, start + head);
+        head++;
     }
+    const croll_byte *src = (const croll_byte *)pa->words + ((start + head) / 8) * pa->bits;
+    croll__unpackBits(src, pa->bits, count - head, out + head);
 }
 
-__STATIC_FUNCTION __CROLL_INLINE_ATTR void croll_bumpDestroy(croll_BumpAlloc *bump) {
-    croll_checkNullPtr(bump) return;
-    croll_checkNullPtr(bump->_next) {
-        free(bump->data);
-        free(bump);
-        return;
+__STATIC_FUNCTION void croll_packedFree(croll_PackedArray *pa) {
+    free(pa->words);
+    croll_daFree(&pa->staging);
+    *pa = (croll_PackedArray){0};
+}
+
+// compressed integer sequences
+
+static void croll__intseqPutVarint(croll_IntSeq *seq, croll_u64 v) {
+    while(v >= 0x80) {
+        croll_daAppend(&seq->data, (croll_byte)(v | 0x80));
+        v >>= 7;
     }
-    while(bump->_next != NULL) {
-        croll_BumpAlloc *next = bump->_next;
-        free(bump->data);
-        free(bump);
-        bump = next;
-    } 
+    croll_daAppend(&seq->data, (croll_byte)v);
 }
 
-// Djb2 hash function
-__STATIC_FUNCTION size_t croll_hashDjb2(const char *str) {
-    size_t hash = 5381;
-    int c;
+static __CROLL_INLINE_ATTR croll_u64 croll__intseqGetVarint(const croll_byte **src) {
+    const croll_byte *p = *src;
+    croll_u64 v = *p & 0x7f;
+    for(size_t shift = 7; *p++ & 0x80; shift += 7)
+        v |= (croll_u64)(*p & 0x7f) << shift;
+    *src = p;
+    return v;
+}
 
-    while ((c = *str++))
-        hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+static void croll__intseqBlock(const croll_IntSeq *seq, size_t block, croll_u64 *out) {
+    const croll__IntSeqSkip *skip = &seq->skips.data[block];
+    const croll_byte *src = seq->data.data + skip->offset;
+    out[0] = skip->first;
 
-    return hash;
+    if(seq->codec == CROLL_INTSEQ_VARINT) {
+        for(size_t j = 1; j < skip->count; j++)
+            out[j] = out[j - 1] + croll__intseqGetVarint(&src);
+        return;
+    }
+
+    croll_u32 deltas[CROLL_INTSEQ_BLOCK];
+    if(skip->bits == 0) memset(deltas, 0, sizeof(deltas));
+    else croll__unpackBits(src, skip->bits, skip->count, deltas);
+    for(size_t j = 1; j < skip->count; j++)
+        out[j] = skip->first + deltas[j];
 }
 
-__STATIC_FUNCTION croll_PoolAlloc *croll_poolNew(size_t pool_size, size_t chunk_size) {
-    if(pool_size == 0 || chunk_size < sizeof(void*))
-    return NULL;
-    chunk_size = croll_ALLOC_ALIGN(chunk_size);
-    /*
-    should somewhat loke like the following:
-    struct chunk {
-        union {
-            void* next;
-            void data[chunk_size];
-        };
-        croll_PoolAlloc *allocator;
-    };
-    */
-    croll_PoolAlloc *pool = malloc(sizeof(croll_PoolAlloc));
-    croll_checkNullPtr(pool) return NULL;
+__STATIC_FUNCTION bool croll_intseqEncode(croll_IntSeq *seq, const croll_u64 *sorted, size_t len, croll_IntSeqCodec codec) {
+    // Validated up front, so a rejected input leaves seq untouched.
+    // Seek trusts skips[].first, so order must hold across block boundaries too.
+    for(size_t i = 1; i < len; i++)
+        if(sorted[i] < sorted[i - 1]) return false;
+    if(codec == CROLL_INTSEQ_FOR)
+        for(size_t i = 0; i < len; i += CROLL_INTSEQ_BLOCK) {
+            size_t last = len - i < CROLL_INTSEQ_BLOCK ? len - 1 : i + CROLL_INTSEQ_BLOCK - 1;
+            if(sorted[last] - sorted[i] > UINT32_MAX) return false;
+        }
 
-    pool->chunks = pool->free_chunks = malloc(pool_size * chunk_size);
-    croll_checkNullPtr(pool->chunks) {
-        free(pool);
-        return NULL;
+    seq->codec = codec;
+    for(size_t i = 0; i < len; i += CROLL_INTSEQ_BLOCK) {
+        size_t count = len - i < CROLL_INTSEQ_BLOCK ? len - i : CROLL_INTSEQ_BLOCK;
+        const croll_u64 *block = sorted + i;
+
+        croll__IntSeqSkip skip = {.first = block[0], .offset = seq->data.len, .count = (croll_u32)count};
+        if(codec == CROLL_INTSEQ_VARINT) {
+            for(size_t j = 1; j < count; j++)
+                croll__intseqPutVarint(seq, block[j] - block[j - 1]);
+        } else {
+            croll_u64 span = block[count - 1] - block[0];
+            skip.bits = span ? (croll_u32)croll__log2(span) + 1 : 0;
+
+            croll_u32 deltas[CROLL_INTSEQ_BLOCK];
+            for(size_t j = 0; j < count; j++) deltas[j] = (croll_u32)(block[j] - block[0]);
+            size_t bytes = (count * skip.bits + 7) / 8;
+            // croll__packBits reads and writes whole 8-byte chunks, so zero a little past the block
+            croll_daReserve(&seq->data, seq->data.len + bytes + sizeof(croll_u64));
+            memset(seq->data.data + seq->data.len, 0, bytes + sizeof(croll_u64));
+            croll__packBits(seq->data.data + seq->data.len, skip.bits, deltas, count);
+            seq->data.len += bytes;
+        }
+        croll_daAppend(&seq->skips, skip);
+        seq->len += count;
     }
 
-    pool->_next = NULL;
-    pool->chunk_size = chunk_size;
-    pool->size = pool_size;
+    // Zeroed slack for the vector loads of the block decoder
+    croll_daReserve(&seq->data, seq->data.len + CROLL__PACK_PADDING);
+    memset(seq->data.data + seq->data.len, 0, CROLL__PACK_PADDING);
+    return true;
+}
 
-    // Reason why chunk_size >= sizeof(void*)
-    croll_byte *chunks = pool->chunks;
-    for(size_t i = 0; i < pool_size - 1; i++)
-        // pool->chunks[i]->next = pool->chunks[i + 1];
-        *(void**)(chunks + i * chunk_size) = chunks + (i + 1) * chunk_size;
+__STATIC_FUNCTION void croll_intseqDecode(const croll_IntSeq *seq, croll_u64 *out) {
+    for(size_t b = 0; b < seq->skips.len; b++)
+        croll__intseqBlock(seq, b, out + b * CROLL_INTSEQ_BLOCK);
+}
 
-    // pool->chunks[pool_size - 1]->next = NULL;
-    *(void**)(chunks + (pool_size - 1) * chunk_size) = NULL;
+__STATIC_FUNCTION void croll_intseqIterInit(croll_IntSeqIter *it, const croll_IntSeq *seq) {
+    it->seq = seq;
+    it->_block = SIZE_MAX;
+    it->_pos = 0;
+    it->_count = 0;
+    it->value = 0;
+}
 
-    return pool;
+static void croll__intseqLoad(croll_IntSeqIter *it, size_t block) {
+    croll__intseqBlock(it->seq, block, it->_buf);
+    it->_block = block;
+    it->_pos = 0;
+    it->_count = it->seq->skips.data[block].count;
 }
 
-__STATIC_FUNCTION __CROLL_INLINE_ATTR void croll_poolDestroy(croll_PoolAlloc *pool) {
-    croll_checkNullPtr(pool) return;
-    croll_checkNullPtr(pool->_next) {
-        free(pool->chunks);
-        free(pool);
-        return;
+__STATIC_FUNCTION bool croll_intseqNext(croll_IntSeqIter *it) {
+    if(it->_pos >= it->_count) {
+        size_t next = it->_block + 1; // SIZE_MAX wraps to the first block
+        if(next >= it->seq->skips.len) return false;
+        croll__intseqLoad(it, next);
     }
-
-    while(pool->_next != NULL) {
-        croll_PoolAlloc *next = pool->_next;
-        free(pool->chunks);
-        free(pool);
-        pool = next;
-    } 
+    it->value = it->_buf[it->_pos++];
+    return true;
 }
 
-__STATIC_FUNCTION void *croll_poolAlloc(croll_PoolAlloc *pool) {
-    croll_checkNullPtr(pool) return NULL;
-    croll_checkNullPtr(pool->free_chunks) {
-        while(pool->_next != NULL) {
-            pool = pool->_next;
-            if(pool->free_chunks != NULL) return croll_poolAlloc(pool);
-        }
-        pool->_next = croll_poolNew(pool->size, pool->chunk_size);
-        pool = pool->_next;
+__STATIC_FUNCTION bool croll_intseqSeek(croll_IntSeqIter *it, croll_u64 target) {
+    const croll__IntSeqSkip *skips = it->seq->skips.data;
+    size_t nblocks = it->seq->skips.len;
+    size_t lo = it->_block == SIZE_MAX ? 0 : it->_block;
+    if(lo >= nblocks) return false;
+
+    // Last block, from the current one on, whose first value is <= target
+    size_t hi = nblocks;
+    while(hi - lo > 1) {
+        size_t mid = (lo + hi) / 2;
+        if(skips[mid].first <= target) lo = mid;
+        else hi = mid;
     }
 
-    void *chunk = pool->free_chunks;
-    pool->free_chunks = *(void**)pool->free_chunks;
+    size_t j = 0;
+    if(lo == it->_block) j = it->_pos ? it->_pos - 1 : 0;
+    else croll__intseqLoad(it, lo);
 
-    return chunk;
+    while(j < it->_count && it->_buf[j] < target) j++;
+    if(j == it->_count) {
+        // Everything left in this block is smaller, the next block starts above target
+        if(lo + 1 >= nblocks) {
+            it->_pos = it->_count;
+            return false;
+        }
+        croll__intseqLoad(it, lo + 1);
+        j = 0;
+    }
+    it->_pos = j + 1;
+    it->value = it->_buf[j];
+    return true;
 }
 
-__STATIC_FUNCTION __CROLL_INLINE_ATTR void croll_poolFree(croll_PoolAlloc *pool, void *chunk) {
-    croll_checkNullPtr(pool) return;
-    croll_checkNullPtr(chunk) return;
+__STATIC_FUNCTION size_t croll_intseqIntersect(const croll_IntSeq *a, const croll_IntSeq *b, croll_u64 *out) {
+    croll_IntSeqIter ia, ib;
+    croll_intseqIterInit(&ia, a);
+    croll_intseqIterInit(&ib, b);
+    size_t n = 0;
+    if(!croll_intseqNext(&ia) || !croll_intseqNext(&ib)) return 0;
+
+    // Leapfrog: the smaller side seeks to the larger value
+    for(;;) {
+        if(ia.value == ib.value) {
+            out[n++] = ia.value;
+            if(!croll_intseqNext(&ia) || !croll_intseqNext(&ib)) break;
+        } else if(ia.value < ib.value) {
+            if(!croll_intseqSeek(&ia, ib.value)) break;
+        } else {
+            if(!croll_intseqSeek(&ib, ia.value)) break;
+        }
+    }
+    return n;
+}
 
-    *(void**)chunk = pool->free_chunks;
-    pool->free_chunks = chunk;
+__STATIC_FUNCTION void croll_intseqFree(croll_IntSeq *seq) {
+    croll_daFree(&seq->data);
+    croll_daFree(&seq->skips);
+    *seq = (croll_IntSeq){0};
 }
 
 #endif // CROLL_IMPLEMENTATION
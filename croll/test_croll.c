@@ -1,11 +1,21 @@
 // dev_test_croll.c
+// build: cc -pthread croll/test_croll.c -o test_croll
+// scalar fallbacks: cc -pthread -DCROLL_NO_SIMD croll/test_croll.c -o test_croll_scalar
 #define CROLL_STRIP_PREFIX
 #define CROLL_IMPLEMENTATION
 #define CROLL_HASHTABLE_IMPLEMENTATION
+// small enough for the bump tests to reach it
+#define CROLL_BUMP_MAX_BLOCK_SIZE ((size_t)64 * 1024)
 #include "croll.h"
 
+#include <math.h>
 #include <string.h>
 #include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+
+#define PARTICLE_FIELDS(X) X(float, x) X(float, y) X(int, id)
+croll_soaDecl(Particles, PARTICLE_FIELDS);
 
 int total_tests = 0;
 int failed_tests = 0;
@@ -73,6 +83,201 @@ bool test_da_foreach() {
     return true;
 }
 
+bool test_da_reduce() {
+    size_t lens[] = {1, 7, 33, 1003};
+    for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+        croll_daDecl(croll_i32, ) i32s = {0};
+        croll_daDecl(croll_u64, ) u64s = {0};
+        croll_daDecl(croll_f32, ) f32s = {0};
+        croll_u32 seed = 12345;
+        for (size_t i = 0; i < lens[l]; i++) {
+            seed = seed * 1103515245 + 12345;
+            croll_daAppend(&i32s, (croll_i32)(seed >> 8) - (1 << 22));
+            croll_daAppend(&u64s, (croll_u64)seed << 31);
+            croll_daAppend(&f32s, (croll_f32)(seed % 1000));
+        }
+
+        croll_i32 min = i32s.data[0], max = i32s.data[0];
+        croll_i64 sum = 0;
+        size_t argmax = 0, count = 0;
+        croll_daForEach(croll_i32, it, &i32s) {
+            if (*it < min) min = *it;
+            if (*it > max) { max = *it; argmax = croll_daForEach_index(it, &i32s); }
+            sum += *it;
+            count += *it == i32s.data[lens[l] / 2];
+        }
+        ASSERT(croll_daMin(&i32s) == min);
+        ASSERT(croll_daMax(&i32s) == max);
+        ASSERT(croll_daSum(&i32s) == sum);
+        ASSERT(croll_daArgMax(&i32s) == argmax);
+        ASSERT(croll_daCount(&i32s, i32s.data[lens[l] / 2]) == count);
+
+        croll_u64 umax = 0, usum = 0;
+        croll_daForEach(croll_u64, it, &u64s) {
+            if (*it > umax) umax = *it;
+            usum += *it;
+        }
+        ASSERT(croll_daMax(&u64s) == umax);
+        ASSERT(croll_daSum(&u64s) == usum);
+
+        croll_f32 fmin = f32s.data[0], fsum = 0;
+        size_t fcount = 0;
+        croll_daForEach(croll_f32, it, &f32s) {
+            if (*it < fmin) fmin = *it;
+            fsum += *it;
+            fcount += *it == 7.0f;
+        }
+        ASSERT(croll_daMin(&f32s) == fmin);
+        ASSERT(croll_daSum(&f32s) == fsum);
+        ASSERT(croll_daCount(&f32s, 7.0f) == fcount);
+
+        // the scalar fallback (the only path under CROLL_NO_SIMD) agrees with the dispatched one
+        ASSERT(croll__minI32Scalar(i32s.data, i32s.len, i32s.data[0]) == min);
+        ASSERT(croll__maxI32Scalar(i32s.data, i32s.len, i32s.data[0]) == max);
+        ASSERT(croll__sumI32Scalar(i32s.data, i32s.len, 0) == sum);
+        ASSERT(croll__countI32Scalar(i32s.data, i32s.len, i32s.data[lens[l] / 2]) == count);
+        ASSERT(croll__maxU64Scalar(u64s.data, u64s.len, u64s.data[0]) == umax);
+        ASSERT(croll__minF32Scalar(f32s.data, f32s.len, f32s.data[0]) == fmin);
+
+        // NaN is skipped the same way whether or not SIMD is used
+        f32s.data[0] = NAN;
+        f32s.data[lens[l] - 1] = NAN;
+        if (lens[l] > 2) {
+            croll_f32 nmin = f32s.data[1], nmax = f32s.data[1];
+            for (size_t i = 1; i < lens[l] - 1; i++) {
+                if (f32s.data[i] < nmin) nmin = f32s.data[i];
+                if (f32s.data[i] > nmax) nmax = f32s.data[i];
+            }
+            ASSERT(croll_daMin(&f32s) == nmin);
+            ASSERT(croll_daMax(&f32s) == nmax);
+            ASSERT(f32s.data[croll_daArgMax(&f32s)] == nmax);
+        } else {
+            ASSERT(isnan(croll_daMin(&f32s)));
+        }
+
+        croll_daFree(&i32s);
+        croll_daFree(&u64s);
+        croll_daFree(&f32s);
+    }
+    return true;
+}
+
+bool test_seg_array() {
+    croll_segDecl(int, ) arr = {0};
+
+    croll_segAppend(&arr, 0);
+    int *first = &croll_segAt(&arr, 0);
+
+    for (int i = 1; i < 10000; i++)
+        croll_segAppend(&arr, i);
+
+    ASSERT(arr.len == 10000);
+    ASSERT(first == &croll_segAt(&arr, 0));
+    for (int i = 0; i < 10000; i++)
+        ASSERT(croll_segAt(&arr, i) == i);
+    ASSERT(croll_segLast(&arr) == 9999);
+
+    croll_segFree(&arr);
+    ASSERT(arr.len == 0 && arr.segs[0] == NULL);
+    return true;
+}
+
+bool test_da_inline() {
+    croll_daDeclInline(int, , 8) arr = croll_daInlineInit(arr);
+
+    for (int i = 0; i < 8; i++)
+        croll_daAppend(&arr, i);
+    ASSERT(arr.data == arr._inline);
+    ASSERT(arr.len == 8 && arr.cap == 8);
+
+    int values[20];
+    for (int i = 0; i < 20; i++) values[i] = 8 + i;
+    croll_daExtend(&arr, values, 20);
+    ASSERT(arr.data != arr._inline);
+    ASSERT(arr.len == 28);
+
+    int sum = 0;
+    croll_daForEach(int, it, &arr) {
+        ASSERT(*it == croll_daForEach_index(it, &arr));
+        sum += *it;
+    }
+    ASSERT(sum == 27 * 28 / 2);
+    croll_daFree(&arr);
+
+    croll_daInlineReset(&arr);
+    croll_daAppend(&arr, 42);
+    ASSERT(arr.data == arr._inline && croll_daLast(&arr) == 42);
+    croll_daFree(&arr);
+    return true;
+}
+
+bool test_soa() {
+    Particles ps = {0};
+
+    for (int i = 0; i < 100; i++)
+        croll_soaAppend(Particles, &ps, .x = (float)i, .y = (float)(2 * i), .id = i);
+    croll_soaAppend(Particles, &ps, 0.5f, 1.5f, 100);
+
+    ASSERT(ps.len == 101);
+    ASSERT(ps.cap >= 101);
+
+    float sum_x = 0;
+    for (size_t i = 0; i < ps.len; i++)
+        sum_x += ps.x[i];
+    ASSERT(sum_x == 4950.5f);
+
+    struct ParticlesRow row = croll_soaGet(Particles, &ps, 42);
+    ASSERT(row.x == 42.0f && row.y == 84.0f && row.id == 42);
+    ASSERT(ps.id[100] == 100 && ps.y[100] == 1.5f);
+
+    croll_soaFree(Particles, &ps);
+    ASSERT(ps.x == NULL && ps.len == 0);
+    return true;
+}
+
+bool test_grid() {
+    croll_gridDecl(int, ) grid = {0};
+    croll_gridInit(&grid, 37, 70);
+    for (size_t r = 0; r < grid.rows; r++)
+        for (size_t c = 0; c < grid.cols; c++)
+            croll_gridAt(&grid, r, c) = (int)(r * 1000 + c);
+
+    size_t n = 0;
+    croll_gridForEachInRow(int, it, &grid, 5) {
+        ASSERT(*it == (int)(5000 + n));
+        n++;
+    }
+    ASSERT(n == 70);
+
+    n = 0;
+    croll_gridForEachInCol(int, it, &grid, 3) {
+        ASSERT(*it == (int)(n * 1000 + 3));
+        n++;
+    }
+    ASSERT(n == 37);
+
+    croll_gridDecl(int, ) transposed = {0};
+    croll_gridInit(&transposed, 70, 37);
+    croll_gridTranspose(&transposed, &grid);
+    for (size_t r = 0; r < transposed.rows; r++)
+        for (size_t c = 0; c < transposed.cols; c++)
+            ASSERT(croll_gridAt(&transposed, r, c) == croll_gridAt(&grid, c, r));
+
+    croll_gridDecl(croll_u16, ) tiled = {0};
+    croll_gridInitTiled(&tiled, 10, 13, 3);
+    ASSERT(tiled.stride == 16);
+    for (size_t r = 0; r < tiled.rows; r++)
+        for (size_t c = 0; c < tiled.cols; c++)
+            croll_gridAt(&tiled, r, c) = (croll_u16)(r * 100 + c);
+    ASSERT(&croll_gridAt(&tiled, 0, 8) == tiled.data + 64); // second tile
+    ASSERT(croll_gridAt(&tiled, 9, 12) == 912);
+
+    croll_gridFree(&grid);
+    croll_gridFree(&transposed);
+    croll_gridFree(&tiled);
+    return true;
+}
+
 bool test_stringbuilder() {
     croll_StringBuilder sb = {0};
     const char *hello = "hello";
@@ -143,11 +348,287 @@ bool test_bumpallocator() {
     croll_bumpReset(arena);
     ASSERT(arena->_next->offset == 0);
     ASSERT(arena->offset == 0);
+    ASSERT(arena->_current == arena);
+
+    // blocks double and allocation continues from the last one
+    for (int n = 0; n < 1000; n++)
+        ASSERT(croll_bumpAllocOrExpand(arena, 24) != NULL);
+    size_t blocks = 0, prev_size = 0;
+    for (croll_BumpAlloc *b = arena; b != NULL; b = b->_next, blocks++) {
+        ASSERT(b->size >= prev_size);
+        prev_size = b->size;
+        if (b->_next == NULL) ASSERT(arena->_current == b);
+    }
+    ASSERT(blocks < 16);
+
+    croll_bumpDestroy(arena);
+
+    // a request over the cap gets a side block, later blocks stay capped
+    arena = croll_bumpNew(4096);
+    ASSERT(croll_bumpAllocOrExpand(arena, 100) != NULL);
+    ASSERT(croll_bumpAllocOrExpand(arena, 1024 * 1024) != NULL);
+    ASSERT(arena->_current == arena && arena->offset == 104 && arena->_next == NULL);
+    ASSERT(arena->_side != NULL && arena->_side->size == 1024 * 1024);
+    for (int n = 0; n < 2000; n++)
+        ASSERT(croll_bumpAllocOrExpand(arena, 1024) != NULL);
+    for (croll_BumpAlloc *b = arena; b != NULL; b = b->_next)
+        ASSERT(b->size <= CROLL_BUMP_MAX_BLOCK_SIZE);
+    // the side block goes with a rewind past it, and with a reset
+    croll_BumpMark before_side = croll_bumpMark(arena);
+    ASSERT(croll_bumpAllocAlignedOrExpand(arena, 256 * 1024, 4096) != NULL);
+    ASSERT(arena->_side != before_side._side);
+    croll_bumpRewind(arena, before_side);
+    ASSERT(arena->_side == before_side._side);
+    croll_bumpReset(arena);
+    ASSERT(arena->_side == NULL);
+    croll_bumpDestroy(arena);
+
+    croll_BumpAlloc *aligned = croll_bumpNewAligned(1000, CROLL_CACHE_LINE);
+    ASSERT(aligned != NULL);
+    ASSERT(((uintptr_t)aligned->data & (CROLL_CACHE_LINE - 1)) == 0);
+    ASSERT(croll_bumpAlloc(aligned, 3) != NULL);
+    size_t aligns[] = {16, 32, 64, 256, 4096};
+    for (size_t i = 0; i < 5; i++) {
+        void *p = croll_bumpAllocAlignedOrExpand(aligned, 40, aligns[i]);
+        ASSERT(p != NULL);
+        ASSERT(((uintptr_t)p & (aligns[i] - 1)) == 0);
+    }
+    // the chained block keeps the arena's alignment
+    ASSERT(aligned->_next != NULL);
+    ASSERT(((uintptr_t)aligned->_next->data & (CROLL_CACHE_LINE - 1)) == 0);
+    croll_bumpReset(aligned);
+    ASSERT(croll_bumpAllocAligned(aligned, 2000, 64) == NULL);
+    croll_bumpDestroy(aligned);
+
+    croll_BumpAlloc *scratch = croll_bumpNew(256);
+    ASSERT(croll_bumpAllocOrExpand(scratch, 100) != NULL);
+    croll_BumpMark mark = croll_bumpMark(scratch);
+    for (int n = 0; n < 50; n++)
+        ASSERT(croll_bumpAllocOrExpand(scratch, 64) != NULL);
+    ASSERT(scratch->_current != scratch);
+    croll_bumpRewind(scratch, mark);
+    ASSERT(scratch->_current == scratch && scratch->offset == 104);
+    ASSERT(scratch->_next->offset == 0);
+
+    // every pass reuses the same, already touched memory
+    void *first = NULL;
+    for (int pass = 0; pass < 10; pass++) {
+        croll_bumpScope(scratch) {
+            void *tmp = croll_bumpAllocOrExpand(scratch, 1000);
+            if (pass == 0) first = tmp;
+            ASSERT(tmp == first);
+            croll_bumpScope(scratch) ASSERT(croll_bumpAllocOrExpand(scratch, 8) != NULL);
+        }
+    }
+    ASSERT(scratch->_current == scratch && scratch->offset == 104);
+    croll_bumpDestroy(scratch);
+
+    // one spike, then steady small load: the spike's blocks get trimmed
+    croll_BumpAlloc *service = croll_bumpNew(1024);
+    croll_BumpTrimPolicy policy = {0};
+    for (int request = 0; request < 20; request++) {
+        size_t n = request == 3 ? 1000 : 10;
+        for (size_t i = 0; i < n; i++) ASSERT(croll_bumpAllocOrExpand(service, 512) != NULL);
+        croll_bumpResetAdaptive(service, &policy);
+    }
+    size_t total = 0;
+    for (croll_BumpAlloc *b = service; b != NULL; b = b->_next) total += b->size;
+    ASSERT(total < 64 * 1024);
+
+    croll_bumpResetTrim(service, 0);
+    ASSERT(service->_next == NULL);
+    ASSERT(croll_bumpAllocOrExpand(service, 4096) != NULL);
+    croll_bumpDestroy(service);
+    return true;
+}
+
+// Builds "0,1,...,n-1" in out, with its temporaries on a scratch arena
+char *scratch_join(croll_BumpAlloc *out, int n) {
+    croll_Scratch tmp = croll_scratchBegin(out);
+    char **parts = croll_bumpAllocOrExpand(tmp.arena, n * sizeof(char *));
+    size_t total = 1;
+    for (int i = 0; i < n; i++) {
+        parts[i] = croll_bumpAllocOrExpand(tmp.arena, 16);
+        total += snprintf(parts[i], 16, i ? ",%d" : "%d", i);
+    }
+    char *result = croll_bumpAllocOrExpand(out, total);
+    result[0] = '\0';
+    for (int i = 0; i < n; i++) strcat(result, parts[i]);
+    croll_scratchEnd(tmp);
+    return result;
+}
+
+void *scratch_thread(void *arg) {
+    croll_Scratch tmp = croll_scratchBegin();
+    *(croll_BumpAlloc **)arg = tmp.arena;
+    croll_scratchEnd(tmp);
+    croll_scratchRelease();
+    return NULL;
+}
+
+bool test_scratch() {
+    croll_Scratch outer = croll_scratchBegin();
+    croll_BumpMark before = outer.mark;
+
+    // the callee's temporaries land on the other scratch arena, the result on ours
+    char *joined = scratch_join(outer.arena, 5);
+    ASSERT(strcmp(joined, "0,1,2,3,4") == 0);
+    ASSERT(outer.arena->_current->offset > before.offset);
+
+    // after an end, the same scratch starts from the same place again
+    croll_Scratch again = croll_scratchBegin(outer.arena);
+    ASSERT(again.arena != outer.arena);
+    croll_BumpMark mark = again.mark;
+    ASSERT(croll_bumpAllocOrExpand(again.arena, 100) != NULL);
+    croll_scratchEnd(again);
+    again = croll_scratchBegin(outer.arena);
+    ASSERT(again.mark.block == mark.block && again.mark.offset == mark.offset);
+    croll_scratchEnd(again);
+    croll_scratchEnd(outer);
+
+    croll_BumpAlloc *other = NULL;
+    pthread_t thread;
+    pthread_create(&thread, NULL, scratch_thread, &other);
+    pthread_join(thread, NULL);
+    ASSERT(other != NULL && other != outer.arena);
+
+    croll_scratchRelease();
+    return true;
+}
+
+bool test_bump_stats() {
+    croll_BumpAlloc *arena = croll_bumpNew(64);
+    ASSERT(arena != NULL);
+
+    ASSERT(croll_bumpAllocOrExpand(arena, 5) != NULL);   // rounds to 8
+    ASSERT(croll_bumpAllocOrExpand(arena, 48) != NULL);  // 56 of 64 used
+    ASSERT(croll_bumpAllocOrExpand(arena, 16) != NULL);  // leaves 8 bytes behind
+    ASSERT(croll_bumpAllocAligned(arena, 8, 64) != NULL);
+
+    croll_BumpStats stats = croll_bumpStats(arena);
+    ASSERT(stats.blocks == 2);
+    ASSERT(stats.reserved == 64 + 128);
+    ASSERT(stats.tail_waste == 8);
+    ASSERT(stats.in_use >= 56 + 16 + 8);
+#ifdef CROLL_BUMP_STATS
+    ASSERT(stats.allocations == 4);
+    ASSERT(stats.requested == 5 + 48 + 16 + 8);
+    ASSERT(stats.consumed == stats.in_use);
+    ASSERT(stats.histogram[2] == 1 && stats.histogram[5] == 1 && stats.histogram[4] == 1 && stats.histogram[3] == 1);
+
+    // the peak survives resets, in_use does not
+    size_t peak = stats.peak;
+    ASSERT(peak == stats.in_use);
+    croll_bumpReset(arena);
+    ASSERT(croll_bumpAllocOrExpand(arena, 8) != NULL);
+    stats = croll_bumpStats(arena);
+    ASSERT(stats.peak == peak && stats.in_use == 8 && stats.resets == 1);
+
+    croll_BumpMark mark = croll_bumpMark(arena);
+    ASSERT(croll_bumpAllocOrExpand(arena, 200) != NULL);
+    croll_bumpRewind(arena, mark);
+    ASSERT(croll_bumpAllocOrExpand(arena, 8) != NULL);
+    ASSERT(croll_bumpStats(arena).peak == 8 + 200);
+#endif
 
     croll_bumpDestroy(arena);
     return true;
 }
 
+#define ATOMIC_ARENA_THREADS 4
+#define ATOMIC_ARENA_ALLOCS 5000
+
+typedef struct {
+    croll_AtomicArena *arena;
+    croll_u64 *ptrs[ATOMIC_ARENA_ALLOCS];
+    croll_u64 id;
+} atomic_arena_arg;
+
+void *atomic_arena_worker(void *p) {
+    atomic_arena_arg *arg = p;
+    for (size_t i = 0; i < ATOMIC_ARENA_ALLOCS; i++) {
+        croll_u64 *mem = croll_atomicArenaAlloc(arg->arena, 3 * sizeof(croll_u64));
+        if (mem == NULL) return NULL;
+        mem[0] = mem[1] = mem[2] = arg->id * ATOMIC_ARENA_ALLOCS + i;
+        arg->ptrs[i] = mem;
+        if (i % 500 == 0) {
+            // oversized, gets its own block
+            croll_byte *big = croll_atomicArenaAlloc(arg->arena, 3000);
+            if (big == NULL) return NULL;
+            memset(big, 0xAB, 3000);
+        }
+    }
+    return NULL;
+}
+
+bool test_atomic_arena() {
+    croll_AtomicArena *arena = croll_atomicArenaNew(4096);
+    ASSERT(arena != NULL);
+
+    static atomic_arena_arg args[ATOMIC_ARENA_THREADS];
+    pthread_t threads[ATOMIC_ARENA_THREADS];
+    for (croll_u64 t = 0; t < ATOMIC_ARENA_THREADS; t++) {
+        args[t].arena = arena;
+        args[t].id = t;
+        pthread_create(&threads[t], NULL, atomic_arena_worker, &args[t]);
+    }
+    for (size_t t = 0; t < ATOMIC_ARENA_THREADS; t++)
+        pthread_join(threads[t], NULL);
+
+    // no two allocations overlapped
+    for (croll_u64 t = 0; t < ATOMIC_ARENA_THREADS; t++)
+        for (size_t i = 0; i < ATOMIC_ARENA_ALLOCS; i++) {
+            croll_u64 *mem = args[t].ptrs[i];
+            ASSERT(mem != NULL);
+            ASSERT(mem[0] == t * ATOMIC_ARENA_ALLOCS + i && mem[2] == mem[0]);
+        }
+
+    // oversized requests leave the current block in place
+    croll__AtomicBlock *current = atomic_load(&arena->current);
+    size_t offset = atomic_load(&current->offset);
+    ASSERT(croll_atomicArenaAlloc(arena, 100000) != NULL);
+    ASSERT(atomic_load(&arena->current) == current && atomic_load(&current->offset) == offset);
+    croll_atomicArenaReset(arena);
+    ASSERT(croll_atomicArenaAlloc(arena, 8) != NULL);
+    croll_atomicArenaDestroy(arena);
+    return true;
+}
+
+bool test_varena() {
+#ifdef CROLL_HAS_VARENA
+    int flags[] = {0, CROLL_VARENA_HUGEPAGES};
+    for (size_t f = 0; f < 2; f++) {
+        croll_VArena *va = croll_varenaNew((size_t)1 << 30, flags[f]);
+        ASSERT(va != NULL);
+        ASSERT(va->committed == 0);
+        ASSERT(((uintptr_t)va->base & (va->commit_step - 1)) == 0);
+
+        // grows in place, one contiguous range
+        char *prev = NULL;
+        for (int i = 0; i < 100; i++) {
+            char *p = croll_varenaAlloc(va, 10000);
+            ASSERT(p != NULL);
+            ASSERT(prev == NULL || p == prev + 10000);
+            memset(p, i, 10000);
+            prev = p;
+        }
+        ASSERT(va->committed >= 100 * 10000 && va->committed < 100 * 10000 + va->commit_step);
+        ASSERT(((uintptr_t)croll_varenaAllocAligned(va, 1, 4096) & 4095) == 0);
+        ASSERT(croll_varenaAlloc(va, (size_t)1 << 31) == NULL);
+
+        croll_varenaReset(va);
+        ASSERT(croll_varenaAlloc(va, 8) == (void *)va->base);
+
+        croll_varenaResetTrim(va, 1);
+        ASSERT(va->committed == va->commit_step);
+        char *p = croll_varenaAlloc(va, 3 * va->commit_step);
+        ASSERT(p != NULL && p[2 * va->commit_step] == 0); // recommitted pages come back zeroed
+        croll_varenaDestroy(va);
+    }
+#endif
+    return true;
+}
+
 bool test_poolallocator() {
     croll_PoolAlloc *pool = croll_poolNew(1, 16);
 
@@ -165,6 +646,43 @@ bool test_poolallocator() {
     croll_poolFree(pool, world);   
     croll_poolDestroy(pool);
 
+    // freed chunks of every block are reused before the pool grows again
+    pool = croll_poolNew(8, sizeof(size_t));
+    ASSERT(pool != NULL);
+    size_t *chunks[100];
+    for (size_t i = 0; i < 100; i++) {
+        chunks[i] = croll_poolAlloc(pool);
+        ASSERT(chunks[i] != NULL);
+        *chunks[i] = i;
+    }
+    for (size_t i = 0; i < 100; i++)
+        ASSERT(*chunks[i] == i);
+
+    size_t blocks = 0;
+    for (croll_PoolAlloc *b = pool; b != NULL; b = b->_next) blocks++;
+    ASSERT(blocks == 13);
+
+    for (size_t i = 0; i < 100; i += 3)
+        croll_poolFree(pool, chunks[i]);
+    for (size_t i = 0; i < 100; i += 3)
+        ASSERT(croll_poolAlloc(pool) != NULL);
+
+    size_t blocks_after = 0;
+    for (croll_PoolAlloc *b = pool; b != NULL; b = b->_next) blocks_after++;
+    ASSERT(blocks_after == blocks);
+
+    // ownership: every chunk of every block, nothing in between or outside
+    ASSERT(pool->_blocks.len == blocks);
+    for (size_t i = 0; i < 100; i++) {
+        ASSERT(croll_poolOwns(pool, chunks[i]));
+        ASSERT(!croll_poolOwns(pool, (char *)chunks[i] + 4));
+    }
+    size_t local;
+    ASSERT(!croll_poolOwns(pool, &local));
+    ASSERT(!croll_poolOwns(pool, chunks));
+    ASSERT(!croll_poolOwns(pool, pool->_carve)); // not carved yet
+    croll_poolDestroy(pool);
+
     return true;
 }
 
@@ -193,12 +711,537 @@ bool test_readfile() {
     return true;
 }
 
+#define RING_TEST_COUNT 200000
+
+void *ring_producer(void *arg) {
+    croll_Ring *ring = arg;
+    croll_u32 batch[64];
+    croll_u32 next = 0;
+    while (next < RING_TEST_COUNT) {
+        if (next % 3 == 0) {
+            if (!croll_ringPush(ring, &next)) { sched_yield(); continue; }
+            next++;
+        } else {
+            croll_u32 n = 0;
+            while (n < 64 && next + n < RING_TEST_COUNT) { batch[n] = next + n; n++; }
+            size_t pushed = croll_ringPushBatch(ring, batch, n);
+            if (pushed == 0) sched_yield();
+            next += (croll_u32)pushed;
+        }
+    }
+    return NULL;
+}
+
+bool test_ring() {
+    croll_Ring *ring = croll_ringNew(1000, sizeof(croll_u32));
+    ASSERT(ring != NULL);
+    ASSERT(ring->mask + 1 == 1024);
+
+    // capacities that can't be rounded up or whose size overflows are rejected
+    ASSERT(croll_ringNew(SIZE_MAX, 1) == NULL);
+    ASSERT(croll_ringNew(SIZE_MAX / 2 + 2, 1) == NULL);
+    ASSERT(croll_ringNew(1 << 20, SIZE_MAX / 4) == NULL);
+
+    croll_u32 value = 7;
+    ASSERT(croll_ringPop(ring, &value) == false);
+    ASSERT(croll_ringPush(ring, &value));
+    ASSERT(croll_ringLen(ring) == 1);
+    value = 0;
+    ASSERT(croll_ringPop(ring, &value) && value == 7);
+
+    pthread_t producer;
+    ASSERT(pthread_create(&producer, NULL, ring_producer, ring) == 0);
+
+    croll_u32 expected = 0, out[100];
+    bool in_order = true;
+    while (expected < RING_TEST_COUNT) {
+        size_t n = croll_ringPopBatch(ring, out, 100);
+        if (n == 0) { sched_yield(); continue; }
+        for (size_t i = 0; i < n; i++)
+            in_order &= out[i] == expected++;
+    }
+    pthread_join(producer, NULL);
+
+    ASSERT(in_order);
+    ASSERT(croll_ringLen(ring) == 0);
+    croll_ringDestroy(ring);
+    return true;
+}
+
+#define MPMC_TEST_THREADS 3
+#define MPMC_TEST_PER_THREAD 20000
+
+void *mpmc_producer(void *arg) {
+    croll_MpmcQueue *q = arg;
+    for (croll_u64 i = 1; i <= MPMC_TEST_PER_THREAD; i++)
+        croll_mpmcPush(q, &i);
+    return NULL;
+}
+
+void *mpmc_consumer(void *arg) {
+    croll_MpmcQueue *q = *(croll_MpmcQueue **)arg;
+    croll_u64 sum = 0, value;
+    for (int i = 0; i < MPMC_TEST_PER_THREAD; i++) {
+        croll_mpmcPop(q, &value);
+        sum += value;
+    }
+    *(croll_u64 *)arg = sum;
+    return NULL;
+}
+
+bool test_mpmc() {
+    croll_MpmcQueue *q = croll_mpmcNew(16, sizeof(croll_u64));
+    ASSERT(q != NULL);
+    ASSERT(croll_mpmcNew(SIZE_MAX, sizeof(croll_u64)) == NULL);
+    ASSERT(croll_mpmcNew(1 << 20, SIZE_MAX / 8) == NULL);
+
+    croll_u64 value = 5;
+    ASSERT(!croll_mpmcTryPop(q, &value));
+    ASSERT(croll_mpmcTryPush(q, &value));
+    value = 0;
+    ASSERT(croll_mpmcTryPop(q, &value) && value == 5);
+
+    pthread_t producers[MPMC_TEST_THREADS], consumers[MPMC_TEST_THREADS];
+    union { croll_MpmcQueue *q; croll_u64 sum; } results[MPMC_TEST_THREADS];
+    for (int i = 0; i < MPMC_TEST_THREADS; i++) {
+        results[i].q = q;
+        ASSERT(pthread_create(&consumers[i], NULL, mpmc_consumer, &results[i]) == 0);
+    }
+    for (int i = 0; i < MPMC_TEST_THREADS; i++)
+        ASSERT(pthread_create(&producers[i], NULL, mpmc_producer, q) == 0);
+
+    croll_u64 total = 0;
+    for (int i = 0; i < MPMC_TEST_THREADS; i++) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+    }
+    for (int i = 0; i < MPMC_TEST_THREADS; i++)
+        total += results[i].sum;
+
+    croll_u64 per_thread = (croll_u64)MPMC_TEST_PER_THREAD * (MPMC_TEST_PER_THREAD + 1) / 2;
+    ASSERT(total == per_thread * MPMC_TEST_THREADS);
+    ASSERT(!croll_mpmcTryPop(q, &value));
+
+    croll_mpmcDestroy(q);
+    return true;
+}
+
+bool test_heap() {
+    croll_Heap heap = {0};
+    croll_u64 keys[] = {50, 20, 80, 10, 60, 30, 70, 40, 90, 0};
+    for (size_t i = 0; i < 10; i++)
+        croll_heapPush(&heap, keys[i], i);
+
+    ASSERT(croll_heapPeek(&heap).key == 0);
+    for (croll_u64 expected = 0; expected < 100; expected += 10) {
+        croll_HeapNode node = croll_heapPop(&heap);
+        ASSERT(node.key == expected);
+        ASSERT(keys[node.value] == expected);
+    }
+    ASSERT(heap.nodes.len == 0);
+
+    // bulk load, then decrease a key through the index map
+    croll_Heap binary = {.arity = 2, .indexed = true};
+    croll_HeapNode nodes[1000];
+    for (croll_u64 i = 0; i < 1000; i++)
+        nodes[i] = (croll_HeapNode){(i * 7919) % 1000 + 10, i};
+    croll_daExtend(&binary.nodes, nodes, 1000);
+    croll_heapify(&binary);
+
+    ASSERT(croll_heapContains(&binary, 500));
+    ASSERT(!croll_heapDecreaseKey(&binary, 500, 5000));
+    ASSERT(croll_heapDecreaseKey(&binary, 500, 3));
+    ASSERT(croll_heapPop(&binary).value == 500);
+    ASSERT(!croll_heapContains(&binary, 500));
+
+    croll_u64 prev = 0;
+    while (binary.nodes.len > 0) {
+        croll_HeapNode node = croll_heapPop(&binary);
+        ASSERT(node.key >= prev);
+        prev = node.key;
+    }
+
+    croll_heapFree(&heap);
+    croll_heapFree(&binary);
+    return true;
+}
+
+bool test_bitset() {
+    croll_Bitset a = croll_bitsetNew(10000);
+    croll_Bitset b = croll_bitsetNew(10000);
+    croll_Bitset c = croll_bitsetNew(10000);
+    ASSERT(a.words != NULL && b.words != NULL && c.words != NULL);
+
+    size_t count_a = 0;
+    for (size_t i = 0; i < 10000; i += 3) { croll_bitsetSet(&a, i); count_a++; }
+    for (size_t i = 0; i < 10000; i += 5) croll_bitsetSet(&b, i);
+    croll_bitsetClear(&a, 9);
+    count_a--;
+
+    ASSERT(croll_bitsetTest(&a, 3) && !croll_bitsetTest(&a, 9) && !croll_bitsetTest(&a, 4));
+    ASSERT(croll_bitsetCount(&a) == count_a);
+
+    croll_bitsetAnd(&c, &a, &b); // multiples of 15
+    ASSERT(croll_bitsetCount(&c) == 667);
+    croll_bitsetOr(&c, &a, &b);
+    ASSERT(croll_bitsetCount(&c) == count_a + 2000 - 667);
+    croll_bitsetAndNot(&c, &a, &b);
+    ASSERT(croll_bitsetCount(&c) == count_a - 667);
+    croll_bitsetXor(&c, &c, &c);
+    ASSERT(croll_bitsetCount(&c) == 0);
+
+    ASSERT(croll_bitsetNext(&a, 7) == 12);
+    ASSERT(croll_bitsetNext(&c, 0) == c.nbits);
+
+    ASSERT(croll_bitsetBuildRank(&a));
+    size_t k = 0;
+    for (size_t i = croll_bitsetNext(&a, 0); i < a.nbits; i = croll_bitsetNext(&a, i + 1)) {
+        ASSERT(croll_bitsetRank(&a, i) == k);
+        ASSERT(croll_bitsetSelect(&a, k) == i);
+        k++;
+    }
+    ASSERT(k == count_a);
+    ASSERT(croll_bitsetRank(&a, a.nbits) == count_a);
+    ASSERT(croll_bitsetSelect(&a, count_a) == a.nbits);
+
+    croll_bitsetFree(&a);
+    croll_bitsetFree(&b);
+    croll_bitsetFree(&c);
+    return true;
+}
+
 bool test_hash() {
     size_t hash = croll_hashDjb2("hello");
     croll_UNUSED(hash);
     return true;
 }
 
+bool test_search_array() {
+    croll_daDecl(croll_u64, ) sorted = {0};
+    for (croll_u64 i = 0; i < 1000; i++) {
+        croll_daAppend(&sorted, i * 3);
+        if (i % 7 == 0) croll_daAppend(&sorted, i * 3); // duplicates
+    }
+
+    croll_SearchArray sa = croll_searchFromDa(&sorted);
+    ASSERT(sa.keys != NULL);
+    ASSERT(((uintptr_t)sa.keys & (CROLL_CACHE_LINE - 1)) == 0);
+
+    croll_u64 queries[3100];
+    size_t batch[3100];
+    for (croll_u64 q = 0; q < 3100; q++) {
+        size_t lower = 0, upper = 0;
+        while (lower < sorted.len && sorted.data[lower] < q) lower++;
+        while (upper < sorted.len && sorted.data[upper] <= q) upper++;
+        ASSERT(croll_searchLowerBound(&sa, q) == lower);
+        ASSERT(croll_searchUpperBound(&sa, q) == upper);
+        ASSERT(croll_searchContains(&sa, q) == (q % 3 == 0 && q < 3000));
+        queries[q] = q;
+    }
+
+    croll_searchLowerBoundBatch(&sa, queries, 3100, batch);
+    for (size_t q = 0; q < 3100; q++)
+        ASSERT(batch[q] == croll_searchLowerBound(&sa, queries[q]));
+
+    croll_SearchArray empty = croll_searchNew(NULL, 0);
+    ASSERT(croll_searchLowerBound(&empty, 5) == 0);
+    ASSERT(!croll_searchContains(&empty, 0));
+
+    croll_searchFree(&sa);
+    croll_searchFree(&empty);
+    croll_daFree(&sorted);
+    return true;
+}
+
+bool test_btree() {
+    croll_BTree *tree = croll_btreeNew();
+    ASSERT(tree != NULL);
+
+    // shuffled inserts of the even numbers below 20000
+    for (size_t i = 0; i < 10000; i++) {
+        croll_u64 key = ((i * 7919) % 10000) * 2;
+        ASSERT(croll_btreeSet(tree, key, (void *)(uintptr_t)(key + 1)));
+    }
+    ASSERT(tree->len == 10000);
+    ASSERT(croll_btreeSet(tree, 42, (void *)7));
+    ASSERT(tree->len == 10000);
+    ASSERT(croll_btreeGet(tree, 42) == (void *)7);
+    ASSERT(croll_btreeGet(tree, 1234) == (void *)1235);
+    ASSERT(croll_btreeGet(tree, 1235) == NULL);
+    ASSERT(croll_btreeGet(tree, 20000) == NULL);
+
+    // range scan [101, 201)
+    croll_u64 expected = 102;
+    for (croll_BTreeIter it = croll_btreeSeek(tree, 101); croll_btreeNext(&it) && it.key < 201;) {
+        ASSERT(it.key == expected);
+        expected += 2;
+    }
+    ASSERT(expected == 202);
+
+    size_t count = 0;
+    croll_u64 prev = 0;
+    for (croll_BTreeIter it = croll_btreeFirst(tree); croll_btreeNext(&it);) {
+        ASSERT(count == 0 || it.key > prev);
+        prev = it.key;
+        count++;
+    }
+    ASSERT(count == 10000);
+    croll_btreeDestroy(tree);
+
+    // bulk load, then keep inserting
+    croll_u64 keys[5000];
+    for (size_t i = 0; i < 5000; i++) keys[i] = i * 3;
+    tree = croll_btreeNew();
+    ASSERT(croll_btreeBulkLoad(tree, keys, NULL, 5000));
+    ASSERT(tree->len == 5000);
+    for (size_t i = 0; i < 5000; i++)
+        ASSERT(croll_btreeSet(tree, i * 3 + 1, (void *)1));
+    count = 0;
+    for (croll_BTreeIter it = croll_btreeFirst(tree); croll_btreeNext(&it); count++)
+        ASSERT(it.key == (count / 2) * 3 + count % 2);
+    ASSERT(count == 10000);
+    croll_btreeDestroy(tree);
+
+    croll_BTree *names = croll_btreeNewStr();
+    ASSERT(names != NULL);
+    char buf[32];
+    for (int i = 999; i >= 0; i--) {
+        snprintf(buf, sizeof(buf), "key%03d", i);
+        ASSERT(croll_btreeSetStr(names, croll_sv(buf), (void *)(uintptr_t)(i + 1)));
+    }
+    ASSERT(croll_btreeGetStr(names, croll_sv("key123")) == (void *)124);
+    ASSERT(croll_btreeGetStr(names, croll_sv("key12")) == NULL);
+
+    count = 0;
+    for (croll_BTreeIter it = croll_btreeSeekStr(names, croll_sv("key5")); croll_btreeNext(&it);) {
+        if (it.str.len < 4 || memcmp(it.str.data, "key5", 4) != 0) break;
+        count++;
+    }
+    ASSERT(count == 100);
+    croll_btreeDestroy(names);
+
+    croll_StrView sorted[] = {croll_sv("apple"), croll_sv("banana"), croll_sv("cherry")};
+    names = croll_btreeNewStr();
+    ASSERT(croll_btreeBulkLoadStr(names, sorted, NULL, 3));
+    ASSERT(croll_btreeSetStr(names, croll_sv("blueberry"), (void *)2));
+    ASSERT(croll_btreeGetStr(names, croll_sv("blueberry")) == (void *)2);
+    croll_BTreeIter it = croll_btreeSeekStr(names, croll_sv("b"));
+    ASSERT(croll_btreeNext(&it) && it.str.len == 6 && memcmp(it.str.data, "banana", 6) == 0);
+    ASSERT(croll_btreeNext(&it) && it.str.len == 9);
+    croll_btreeDestroy(names);
+    return true;
+}
+
+typedef struct {
+    size_t count;
+    char last[64];
+    bool sorted;
+} art_visit_state;
+
+bool art_visit(croll_StrView key, void *value, void *user) {
+    (void)value;
+    art_visit_state *state = user;
+    char cur[64];
+    snprintf(cur, sizeof(cur), "%.*s", (int)key.len, key.data);
+    if (state->count > 0 && strcmp(state->last, cur) >= 0) state->sorted = false;
+    strcpy(state->last, cur);
+    state->count++;
+    return true;
+}
+
+bool test_art() {
+    croll_Art *art = croll_artNew();
+    ASSERT(art != NULL);
+
+    // keys that are prefixes of each other and paths longer than the stored prefix
+    const char *words[] = {"a", "ab", "abc", "abcdefghijklmnop", "abcdefghijklmnoq", "abcdefghijXlmnop", "b", ""};
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++)
+        ASSERT(croll_artSet(art, croll_sv(words[i]), (void *)(uintptr_t)(i + 1)));
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++)
+        ASSERT(croll_artGet(art, croll_sv(words[i])) == (void *)(uintptr_t)(i + 1));
+    ASSERT(croll_artGet(art, croll_sv("abcd")) == NULL);
+    ASSERT(croll_artGet(art, croll_sv("abcdefghijklmnoz")) == NULL);
+    ASSERT(croll_artSet(art, croll_sv("ab"), (void *)99));
+    ASSERT(croll_artGet(art, croll_sv("ab")) == (void *)99);
+    ASSERT(art->len == 8);
+
+    char buf[64];
+    for (int i = 0; i < 1000; i++) {
+        snprintf(buf, sizeof(buf), "/users/%d/profile", i);
+        ASSERT(croll_artSet(art, croll_sv(buf), (void *)(uintptr_t)(i + 1)));
+    }
+    // one node per byte value, forces a Node256
+    for (int b = 1; b < 256; b++) {
+        char key[3] = {'z', (char)b, 0};
+        ASSERT(croll_artSet(art, (croll_StrView){key, 2}, (void *)1));
+    }
+    ASSERT(croll_artGet(art, croll_sv("/users/512/profile")) == (void *)513);
+    ASSERT(croll_artGet(art, croll_sv("/users/512/profil")) == NULL);
+
+    art_visit_state state = {.sorted = true};
+    ASSERT(croll_artIterPrefix(art, croll_sv("/users/12"), art_visit, &state) == 11);
+    ASSERT(state.sorted);
+
+    state = (art_visit_state){.sorted = true};
+    ASSERT(croll_artIterPrefix(art, croll_sv("abcdefghij"), art_visit, &state) == 3);
+    ASSERT(state.sorted);
+    ASSERT(croll_artIterPrefix(art, croll_sv("abcdefghijklmnoz"), art_visit, &state) == 0);
+    ASSERT(croll_artIterPrefix(art, croll_sv("abcdefghiY"), art_visit, &state) == 0);
+
+    state = (art_visit_state){.sorted = true};
+    ASSERT(croll_artIterPrefix(art, croll_sv(""), art_visit, &state) == art->len);
+
+    croll_ArtStats stats = croll_artStats(art);
+    ASSERT(stats.leaves == 8 + 1000 + 255);
+    ASSERT(stats.nodes[0] > 0 && stats.nodes[1] > 0 && stats.nodes[3] == 1);
+    ASSERT(stats.node_bytes[3] >= 256 * sizeof(void *));
+
+    croll_artDestroy(art);
+    return true;
+}
+
+bool test_slotmap() {
+    typedef struct { int id; float x; } Entity;
+    croll_SlotMap sm = croll_slotmapNew(sizeof(Entity));
+
+    croll_SlotHandle handles[100];
+    for (int i = 0; i < 100; i++) {
+        handles[i] = croll_slotmapInsert(&sm, &(Entity){i, (float)i});
+        ASSERT(handles[i] != CROLL_SLOT_NULL);
+    }
+    ASSERT(sm.len == 100);
+    ASSERT(((Entity *)croll_slotmapGet(&sm, handles[42]))->id == 42);
+
+    // remove the odd ones, the survivors stay packed and reachable
+    for (int i = 1; i < 100; i += 2)
+        ASSERT(croll_slotmapRemove(&sm, handles[i]));
+    ASSERT(sm.len == 50);
+    ASSERT(!croll_slotmapRemove(&sm, handles[1]));
+    ASSERT(croll_slotmapGet(&sm, handles[1]) == NULL);
+    ASSERT(!croll_slotmapValid(&sm, CROLL_SLOT_NULL));
+    for (int i = 0; i < 100; i += 2)
+        ASSERT(((Entity *)croll_slotmapGet(&sm, handles[i]))->id == i);
+
+    size_t n = 0;
+    croll_slotmapForEach(Entity, e, &sm) {
+        ASSERT(e->id % 2 == 0);
+        ASSERT(croll_slotmapGet(&sm, croll_slotmapHandleAt(&sm, n)) == e);
+        n++;
+    }
+    ASSERT(n == 50);
+
+    // reused slots get a new generation, old handles stay dead
+    croll_SlotHandle reused = croll_slotmapInsert(&sm, &(Entity){1000, 0});
+    ASSERT(reused != handles[99]);
+    ASSERT(croll_slotmapGet(&sm, handles[99]) == NULL);
+    ASSERT(((Entity *)croll_slotmapGet(&sm, reused))->id == 1000);
+
+    // once every encodable index is taken (none free), inserts fail instead of reusing the sentinel
+    size_t slot_count = sm.slots.len;
+    croll_u32 free_head = sm.free_head;
+    sm.slots.len = CROLL__SLOT_CAPACITY;
+    sm.free_head = CROLL__SLOT_NONE;
+    ASSERT(croll_slotmapInsert(&sm, &(Entity){0, 0}) == CROLL_SLOT_NULL);
+    sm.slots.len = slot_count;
+    sm.free_head = free_head;
+
+    croll_slotmapFree(&sm);
+    ASSERT(croll_slotmapGet(&sm, reused) == NULL);
+    return true;
+}
+
+bool test_packed_array() {
+    croll_PackedArray pa = {0};
+    for (croll_u32 i = 0; i < 1000; i++)
+        croll_packedAppend(&pa, (i * 2654435761u) % 2000);
+    ASSERT(croll_packedFreeze(&pa));
+    ASSERT(pa.bits == 11);
+    ASSERT(pa.len == 1000);
+    for (croll_u32 i = 0; i < 1000; i++)
+        ASSERT(croll_packedGet(&pa, i) == (i * 2654435761u) % 2000);
+
+    croll_u32 out[1000];
+    croll_packedUnpack(&pa, 3, 997, out);
+    for (croll_u32 i = 3; i < 1000; i++)
+        ASSERT(out[i - 3] == (i * 2654435761u) % 2000);
+    croll_packedFree(&pa);
+
+    // every width, values straddling word boundaries
+    for (croll_u32 bits = 1; bits <= 32; bits++) {
+        croll_PackedArray fixed = croll_packedNew(200, bits);
+        ASSERT(fixed.words != NULL);
+        croll_u32 mask = bits == 32 ? 0xffffffffu : (1u << bits) - 1;
+        for (croll_u32 i = 0; i < 200; i++)
+            croll_packedSet(&fixed, i, (i * 0x9e3779b9u) & mask);
+        croll_packedSet(&fixed, 100, mask);
+        croll_packedSet(&fixed, 100, (100 * 0x9e3779b9u) & mask);
+        croll_packedUnpack(&fixed, 0, 200, out);
+        for (croll_u32 i = 0; i < 200; i++) {
+            ASSERT(croll_packedGet(&fixed, i) == ((i * 0x9e3779b9u) & mask));
+            ASSERT(out[i] == ((i * 0x9e3779b9u) & mask));
+        }
+        croll_packedFree(&fixed);
+    }
+    return true;
+}
+
+bool test_intseq() {
+    croll_daDecl(croll_u64, ) evens = {0};
+    croll_daDecl(croll_u64, ) threes = {0};
+    for (croll_u64 i = 0; i < 3000; i++) croll_daAppend(&evens, 1000000 + i * 2);
+    for (croll_u64 i = 0; i < 2000; i++) croll_daAppend(&threes, 1000000 + i * 3);
+    croll_daAppend(&threes, 1ull << 40); // big jump, fine for varint
+
+    croll_IntSeqCodec codecs[] = {CROLL_INTSEQ_VARINT, CROLL_INTSEQ_FOR};
+    for (size_t c = 0; c < 2; c++) {
+        croll_IntSeq a = {0}, b = {0};
+        ASSERT(croll_intseqFromDa(&a, &evens, codecs[c]));
+        ASSERT(a.len == 3000);
+        ASSERT(a.data.len < 3000 * sizeof(croll_u64) / 4);
+        if (codecs[c] == CROLL_INTSEQ_FOR) {
+            ASSERT(!croll_intseqFromDa(&b, &threes, codecs[c]));
+            croll_intseqFree(&b);
+            threes.len--;
+        }
+        ASSERT(croll_intseqFromDa(&b, &threes, codecs[c]));
+
+        // each block sorted on its own, but the second starts below the end of the first
+        croll_u64 unsorted[2 * CROLL_INTSEQ_BLOCK];
+        for (size_t i = 0; i < 2 * CROLL_INTSEQ_BLOCK; i++) unsorted[i] = i;
+        unsorted[CROLL_INTSEQ_BLOCK] = 5;
+        croll_IntSeq bad = {0};
+        ASSERT(!croll_intseqEncode(&bad, unsorted, 2 * CROLL_INTSEQ_BLOCK, codecs[c]));
+        ASSERT(bad.len == 0 && bad.skips.len == 0 && bad.data.len == 0);
+        croll_intseqFree(&bad);
+
+        croll_u64 decoded[3000];
+        croll_intseqDecode(&a, decoded);
+        ASSERT(memcmp(decoded, evens.data, sizeof(decoded)) == 0);
+
+        croll_IntSeqIter it;
+        croll_intseqIterInit(&it, &a);
+        ASSERT(croll_intseqSeek(&it, 1000001) && it.value == 1000002);
+        ASSERT(croll_intseqSeek(&it, 1000002) && it.value == 1000002);
+        ASSERT(croll_intseqNext(&it) && it.value == 1000004);
+        ASSERT(croll_intseqSeek(&it, 1004001) && it.value == 1004002);
+        ASSERT(croll_intseqNext(&it) && it.value == 1004004);
+        ASSERT(!croll_intseqSeek(&it, 2000000));
+
+        // multiples of 6 in range
+        croll_u64 common[2000];
+        size_t n = croll_intseqIntersect(&a, &b, common);
+        ASSERT(n == 1000);
+        for (size_t i = 0; i < n; i++) ASSERT(common[i] == 1000000 + i * 6);
+
+        croll_intseqFree(&a);
+        croll_intseqFree(&b);
+    }
+
+    croll_daFree(&evens);
+    croll_daFree(&threes);
+    return true;
+}
+
 bool test_hashtable() {
     croll_BumpAlloc *arena = croll_bumpNew(500);
 
@@ -251,14 +1294,33 @@ void test_all() {
     TEST(test_da_append);
     TEST(test_da_extend);
     TEST(test_da_foreach);
+    TEST(test_da_reduce);
+    TEST(test_seg_array);
+    TEST(test_da_inline);
+    TEST(test_soa);
+    TEST(test_grid);
     TEST(test_stringbuilder);
     TEST(test_sgetline);
     TEST(test_hgetline);
     TEST(test_bumpallocator);
+    TEST(test_varena);
+    TEST(test_scratch);
+    TEST(test_atomic_arena);
+    TEST(test_bump_stats);
     TEST(test_poolallocator);
     TEST(test_hash);
     TEST(test_readfile);
     TEST(test_hashtable);
+    TEST(test_ring);
+    TEST(test_mpmc);
+    TEST(test_heap);
+    TEST(test_bitset);
+    TEST(test_search_array);
+    TEST(test_btree);
+    TEST(test_art);
+    TEST(test_slotmap);
+    TEST(test_packed_array);
+    TEST(test_intseq);
 }
 
 int main(void) {
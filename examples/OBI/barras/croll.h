@@ -149,6 +149,51 @@ static FILE *croll_STDOUT;
 #define croll_daForEach(type, it, da) for(type *it = (da)->data; it < (da)->data + (da)->len; it++)
 #define croll_daForEach_index(it, da) ((it) - (da)->data)
 
+// 2D grid macros
+
+// A rows x cols grid in one contiguous allocation, either row-major or tiled
+// (square tiles of 2^tile_shift elements per side, each tile stored contiguously).
+// Rows and columns are padded to whole tiles, `stride` is the padded column count.
+// Example use:
+// croll_gridDecl(char, ) grid = {0};
+// croll_gridInit(&grid, rows, cols);
+// croll_gridAt(&grid, r, c) = '1';
+// croll_gridForEachInRow(char, it, &grid, r) putchar(*it);
+// croll_gridFree(&grid);
+#define croll_gridDecl(type, name) struct name { type *data; size_t rows, cols, stride; size_t tile_shift; }
+
+#define croll_gridInitTiled(g, nrows, ncols, tshift)                                              \
+    do {                                                                                          \
+        size_t croll__tile = (size_t)1 << (tshift);                                               \
+        (g)->rows = (nrows);                                                                      \
+        (g)->cols = (ncols);                                                                      \
+        (g)->tile_shift = (tshift);                                                               \
+        (g)->stride = ((ncols) + croll__tile - 1) & ~(croll__tile - 1);                           \
+        size_t croll__cells = (((nrows) + croll__tile - 1) & ~(croll__tile - 1)) * (g)->stride;  \
+        (g)->data = calloc(croll__cells > 0 ? croll__cells : 1, sizeof(*(g)->data));             \
+        croll_ASSERT((g)->data != NULL, "Failed to allocate grid at file: "__FILE__);             \
+    } while(0)
+#define croll_gridInit(g, nrows, ncols) croll_gridInitTiled(g, nrows, ncols, 0)
+
+#define croll_gridFree(g) do {free((g)->data); (g)->data = NULL; (g)->rows = 0; (g)->cols = 0; (g)->stride = 0;} while(0)
+
+#define croll_gridAt(g, r, c) ((g)->data[croll__gridIndex((r), (c), (g)->stride, (g)->tile_shift)])
+
+// Row and column iteration, stride-1 along rows (row-major grids only)
+#define croll_gridRow(g, r) ((g)->data + (r) * (g)->stride)
+#define croll_gridForEachInRow(type, it, g, r)                                                    \
+    for(type *it = (croll_ASSERT((g)->tile_shift == 0, "Grid is not row-major at file: "__FILE__), croll_gridRow(g, r)); \
+        it < croll_gridRow(g, r) + (g)->cols; it++)
+#define croll_gridForEachInCol(type, it, g, c)                                                    \
+    for(type *it = (croll_ASSERT((g)->tile_shift == 0, "Grid is not row-major at file: "__FILE__), (g)->data + (c)); \
+        it < (g)->data + (g)->rows * (g)->stride; it += (g)->stride)
+
+// Row-major is the tile_shift == 0 case of the tiled formula
+static inline size_t croll__gridIndex(size_t r, size_t c, size_t stride, size_t ts) {
+    size_t m = ((size_t)1 << ts) - 1;
+    return (((r >> ts) * stride) << ts) + ((c >> ts) << (2 * ts)) + ((r & m) << ts) + (c & m);
+}
+
 // hash table defines
 
 // #define croll_htDeclStart(type, name) struct name { struct {char *key; type value;} *entries; int cap; int len;}
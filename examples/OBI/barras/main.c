@@ -1,3 +1,5 @@
+#include <string.h>
+
 #define CROLL_IMPLEMENTATION
 #include "croll.h"
 
@@ -38,27 +40,24 @@ int main(void) {
         if(tmp > max) max = tmp;
     }
 
-    int **matrix = calloc(cols, sizeof(char*));
-    for(int i = 0; i < cols; i++)
-        matrix[i] = calloc(max, sizeof(char));
+    // one contiguous max x cols grid, filled and printed row by row
+    croll_gridDecl(char,) matrix = {0};
+    croll_gridInit(&matrix, max, cols);
 
-    for(int col = 0; col < cols; col++) {
-        for(int bar = 0; bar < max; bar++) {
-            char one_or_zero = bar < bars.data[col] ? '1' : '0';
-            matrix[col][max - (bar + 1)] = one_or_zero;
+    for(int row = 0; row < max; row++) {
+        for(int col = 0; col < cols; col++) {
+            croll_gridAt(&matrix, row, col) = row >= max - bars.data[col] ? '1' : '0';
         }
     }
 
-    for(int bar = 0; bar < max; bar++) {
-        for(int col = 0; col < cols; col++) {
-            printf("%c", matrix[col][bar]);
+    for(int row = 0; row < max; row++) {
+        croll_gridForEachInRow(char, it, &matrix, row) {
+            printf("%c", *it);
         }
         printf("\n");
     }
 
-    for(int i = 0; i < cols; i++)
-        free(matrix[i]);
-    free(matrix);
+    croll_gridFree(&matrix);
     croll_sbFree(&data);
     croll_daFree(&bars);
     return 0;